@@ -0,0 +1,268 @@
+#ifdef _WIN32
+  #include <io.h>
+  #define NULL_DEVICE "NUL"
+#else
+  #include <unistd.h>
+  #define NULL_DEVICE "/dev/null"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rowen/core.hpp"
+
+#ifndef ROWEN_VERSION
+  #define ROWEN_VERSION "unknown"
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+struct Scenario {
+  const char*        name;
+  rs::Logger::Target target;
+};
+
+static const Scenario SCENARIOS[] = {
+  { "console", rs::Logger::Target::CONSOLE },
+  { "file", rs::Logger::Target::FILE },
+  { "both", rs::Logger::Target::CONSOLE_FILE },
+};
+
+struct Result {
+  std::string target;
+  bool        raw;
+  size_t      message_bytes;
+  int         threads;
+  uint64_t    messages;
+  double      seconds;
+  double      messages_per_sec;
+  double      bytes_per_sec;
+  uint64_t    p50, p99, p999, max;  // latency of a call (ns)
+};
+
+static uint64_t percentile(std::vector<uint32_t>& sorted, double ratio)
+{
+  if (sorted.empty())
+    return 0;
+  auto index = static_cast<size_t>(ratio * (sorted.size() - 1) + 0.5);
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+// `threads` threads log `count` messages each, latency of every call is kept
+static Result run(const Scenario& scenario, bool raw, size_t message_bytes,
+                  int threads, uint64_t count)
+{
+  rs::Logger::setTarget(scenario.target);
+
+  const std::string payload(message_bytes, 'x');
+  std::vector<std::vector<uint32_t>> latencies(threads);
+  std::vector<std::thread>           workers;
+  std::atomic<int>                   ready = { 0 };
+  std::atomic<bool>                  go    = { false };
+
+  for (int t = 0; t < threads; ++t) {
+    latencies[t].resize(count);
+    workers.emplace_back([&, t] {
+      auto& latency = latencies[t];
+      ready++;
+      while (go.load() == false)
+        std::this_thread::yield();
+
+      for (uint64_t i = 0; i < count; ++i) {
+        auto begin = Clock::now();
+        if (raw)
+          rs::Logger::info_raw("%s", payload.c_str());
+        else
+          logger_info("%s", payload.c_str());
+        auto end   = Clock::now();
+        latency[i] = static_cast<uint32_t>(std::min<int64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin)
+                .count(),
+            UINT32_MAX));
+      }
+    });
+  }
+
+  while (ready.load() < threads)
+    std::this_thread::yield();
+  auto begin = Clock::now();
+  go         = true;
+  for (auto& worker : workers)
+    worker.join();
+  rs::Logger::flush();
+  auto end = Clock::now();
+
+  std::vector<uint32_t> merged;
+  merged.reserve(count * threads);
+  for (auto& latency : latencies)
+    merged.insert(merged.end(), latency.begin(), latency.end());
+  std::sort(merged.begin(), merged.end());
+
+  Result result;
+  result.target           = scenario.name;
+  result.raw              = raw;
+  result.message_bytes    = message_bytes;
+  result.threads          = threads;
+  result.messages         = count * threads;
+  result.seconds          = std::chrono::duration<double>(end - begin).count();
+  result.messages_per_sec = result.messages / result.seconds;
+  result.bytes_per_sec    = result.messages * message_bytes / result.seconds;
+  result.p50              = percentile(merged, 0.50);
+  result.p99              = percentile(merged, 0.99);
+  result.p999             = percentile(merged, 0.999);
+  result.max              = merged.empty() ? 0 : merged.back();
+  return result;
+}
+
+static void writeJson(FILE* out, const std::vector<Result>& results,
+                      bool async, int max_threads)
+{
+  char      date[32];
+  time_t    now = time(nullptr);
+  struct tm tm;
+#ifdef _WIN32
+  localtime_s(&tm, &now);
+#else
+  localtime_r(&now, &tm);
+#endif
+  strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", &tm);
+
+  fprintf(out, "{\n");
+  fprintf(out, "  \"version\": \"%s\",\n", ROWEN_VERSION);
+  fprintf(out, "  \"date\": \"%s\",\n", date);
+  fprintf(out, "  \"async\": %s,\n", async ? "true" : "false");
+  fprintf(out, "  \"hardware_threads\": %u,\n",
+          std::thread::hardware_concurrency());
+  fprintf(out, "  \"max_threads\": %d,\n", max_threads);
+  fprintf(out, "  \"results\": [\n");
+  for (size_t i = 0; i < results.size(); ++i) {
+    const auto& r = results[i];
+    fprintf(out,
+            "    {\"target\": \"%s\", \"raw\": %s, \"message_bytes\": %zu, "
+            "\"threads\": %d, \"messages\": %llu, \"seconds\": %.6f, "
+            "\"messages_per_sec\": %.1f, \"bytes_per_sec\": %.1f, "
+            "\"latency_ns\": {\"p50\": %llu, \"p99\": %llu, \"p99.9\": %llu, "
+            "\"max\": %llu}}%s\n",
+            r.target.c_str(), r.raw ? "true" : "false", r.message_bytes,
+            r.threads, static_cast<unsigned long long>(r.messages), r.seconds,
+            r.messages_per_sec, r.bytes_per_sec,
+            static_cast<unsigned long long>(r.p50),
+            static_cast<unsigned long long>(r.p99),
+            static_cast<unsigned long long>(r.p999),
+            static_cast<unsigned long long>(r.max),
+            i + 1 < results.size() ? "," : "");
+  }
+  fprintf(out, "  ]\n}\n");
+}
+
+static void usage(const char* program)
+{
+  printf("usage : %s [-t threads] [-n count] [-a] [-d directory] [-o file]\n",
+         program);
+  printf("  -t : maximum threads, run with 1, 2, 4 .. (default 4)\n");
+  printf("  -n : messages per thread (default 100000, 1/100 for large)\n");
+  printf("  -a : asynchronous logging\n");
+  printf("  -d : log directory (default ./bench-log)\n");
+  printf("  -o : JSON result file (default : none)\n");
+}
+
+int main(int argc, char** argv)
+{
+  int         max_threads = 4;
+  uint64_t    count       = 100000;
+  bool        async       = false;
+  const char* directory   = "./bench-log";
+  const char* output      = nullptr;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+      max_threads = std::max(1, atoi(argv[++i]));
+    else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+      count = std::max<uint64_t>(100, strtoull(argv[++i], nullptr, 10));
+    else if (strcmp(argv[i], "-a") == 0)
+      async = true;
+    else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+      directory = argv[++i];
+    else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+      output = argv[++i];
+    else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  // console output goes to the null device, the report to the real stdout
+#ifdef _WIN32
+  FILE* report = _fdopen(_dup(_fileno(stdout)), "w");
+#else
+  FILE* report = fdopen(dup(fileno(stdout)), "w");
+#endif
+  if (report == nullptr || freopen(NULL_DEVICE, "w", stdout) == nullptr) {
+    fprintf(stderr, "cannot redirect the console output\n");
+    return 1;
+  }
+
+  rs::Logger::setDirectory(directory);
+  rs::Logger::setLevel(rs::Logger::Level::INFO);
+  if (async)
+    rs::Logger::setAsyncLogging(true);
+
+  // small message & over the 16 KiB record buffer
+  const size_t sizes[] = { 64, 20 * 1024 };
+
+  fprintf(report, "%-8s %-4s %6s %7s %12s %10s %8s %8s %8s %9s\n", "target",
+          "raw", "bytes", "threads", "msg/s", "MB/s", "p50 ns", "p99 ns",
+          "p99.9 ns", "max ns");
+  fflush(report);
+
+  // 1, 2, 4 .. max_threads
+  std::vector<int> thread_counts;
+  for (int threads = 1; threads < max_threads; threads *= 2)
+    thread_counts.push_back(threads);
+  thread_counts.push_back(max_threads);
+
+  std::vector<Result> results;
+  for (const auto& scenario : SCENARIOS) {
+    for (bool raw : { false, true }) {
+      for (size_t size : sizes) {
+        for (int threads : thread_counts) {
+          auto messages = size > rs::FormatBuffer::FIXED_SIZE
+                              ? std::max<uint64_t>(count / 100, 100)
+                              : count;
+          auto r = run(scenario, raw, size, threads, messages);
+          results.push_back(r);
+
+          fprintf(report,
+                  "%-8s %-4s %6zu %7d %12.0f %10.1f %8llu %8llu %8llu %9llu\n",
+                  r.target.c_str(), r.raw ? "yes" : "no", r.message_bytes,
+                  r.threads, r.messages_per_sec, r.bytes_per_sec / 1e6,
+                  static_cast<unsigned long long>(r.p50),
+                  static_cast<unsigned long long>(r.p99),
+                  static_cast<unsigned long long>(r.p999),
+                  static_cast<unsigned long long>(r.max));
+          fflush(report);
+        }
+      }
+    }
+  }
+
+  if (output) {
+    FILE* out = fopen(output, "w");
+    if (out == nullptr) {
+      fprintf(stderr, "cannot write %s\n", output);
+      return 1;
+    }
+    writeJson(out, results, async, max_threads);
+    fclose(out);
+  }
+  fclose(report);
+  return 0;
+}
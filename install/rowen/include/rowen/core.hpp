@@ -0,0 +1,21 @@
+#ifndef __ROWEN_CORE_H__
+#define __ROWEN_CORE_H__
+
+#ifndef __BUILD__
+  #include "core/define.hpp"
+  #include "core/function.hpp"
+  #include "core/logCollector.hpp"
+  #include "core/logger.hpp"
+  #include "core/logSink.hpp"
+  #include "core/time.hpp"
+
+#else
+  #include "src/define.hpp"
+  #include "src/function.hpp"
+  #include "src/logCollector.hpp"
+  #include "src/logger.hpp"
+  #include "src/logSink.hpp"
+  #include "src/time.hpp"
+#endif
+
+#endif  //__ROWEN_CORE_H__
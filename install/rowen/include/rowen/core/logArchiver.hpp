@@ -0,0 +1,53 @@
+#ifndef __ROWEN_SDK_CORE_LOGARCHIVER_HPP__
+#define __ROWEN_SDK_CORE_LOGARCHIVER_HPP__
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace rs {
+
+// Background (low priority) processing of finished log files
+//  - compression : {file} -> {file}.gz (zlib build only)
+//  - retention   : the oldest YYYY_MM_DD directories are deleted while the
+//                  log directory exceeds the size budget
+class LogArchiver {
+ public:
+  LogArchiver() = default;
+  ~LogArchiver();
+
+  LogArchiver(const LogArchiver&)            = delete;
+  LogArchiver& operator=(const LogArchiver&) = delete;
+
+  void setCompression(bool enable);
+  void setRetention(const std::string& directory, uint64_t bytes);
+
+  // queue a closed file (never blocks on file I/O)
+  void push(const std::string& path);
+
+  // built with zlib
+  static bool supported();
+
+ private:
+  void run();
+  bool compress(const std::string& path);
+  void applyRetention(const std::string& directory, uint64_t bytes);
+
+ private:
+  std::mutex              mutex_;
+  std::condition_variable convar_;
+  std::deque<std::string> files_;
+  std::thread             thread_;
+  bool                    stop_ = false;
+
+  bool        compression_ = false;
+  std::string directory_;
+  uint64_t    retention_ = 0;
+};
+
+}  // namespace rs
+
+#endif  //__ROWEN_SDK_CORE_LOGARCHIVER_HPP__
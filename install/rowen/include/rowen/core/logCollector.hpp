@@ -0,0 +1,51 @@
+#ifndef __ROWEN_SDK_CORE_LOGCOLLECTOR_HPP__
+#define __ROWEN_SDK_CORE_LOGCOLLECTOR_HPP__
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "logSink.hpp"
+#include "sharedRing.hpp"
+
+namespace rs {
+
+// Single writer of a shared memory ring (SharedRingSink of every process) :
+// records are written in ticket order to one set of rotating files
+// (tools/log-collector, or a process elected with start())
+class LogCollector {
+ public:
+  explicit LogCollector(const std::string& name = "/rowen-log",
+                        size_t capacity = 4096, size_t record_size = 512);
+  ~LogCollector();
+
+  LogCollector(const LogCollector&)            = delete;
+  LogCollector& operator=(const LogCollector&) = delete;
+
+  // collect on a thread (false : ring not opened or another collector runs)
+  bool start(const std::string& directory);
+  void stop();
+
+  // write the records available now, return the number of records
+  size_t collect();
+
+  // output files (size limit, compression, format ...)
+  FileSink& file() { return *file_; }
+
+  uint64_t collected() const { return collected_.load(); }
+
+ private:
+  void run();
+
+ private:
+  SharedRing                ring_;
+  std::shared_ptr<FileSink> file_ = std::make_shared<FileSink>();
+  std::thread               thread_;
+  std::atomic_bool          running_   = { false };
+  std::atomic<uint64_t>     collected_ = { 0 };
+};
+
+}  // namespace rs
+
+#endif  //__ROWEN_SDK_CORE_LOGCOLLECTOR_HPP__
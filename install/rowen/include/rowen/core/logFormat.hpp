@@ -0,0 +1,287 @@
+#ifndef __ROWEN_SDK_CORE_LOGFORMAT_HPP__
+#define __ROWEN_SDK_CORE_LOGFORMAT_HPP__
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace rs {
+
+// Record buffer : fixed storage, grows to the heap only for oversized
+// messages (and keeps that capacity afterwards)
+class FormatBuffer {
+ public:
+  static constexpr size_t FIXED_SIZE = 16384;
+
+  FormatBuffer() = default;
+
+  FormatBuffer(const FormatBuffer&)            = delete;
+  FormatBuffer& operator=(const FormatBuffer&) = delete;
+
+  void        clear() { size_ = 0; }
+  char*       data() { return data_; }
+  const char* data() const { return data_; }
+  size_t      size() const { return size_; }
+
+  void append(const char* str, size_t length)
+  {
+    reserve(size_ + length);
+    memcpy(data_ + size_, str, length);
+    size_ += length;
+  }
+
+  void append(char c)
+  {
+    reserve(size_ + 1);
+    data_[size_++] = c;
+  }
+
+  void printf(const char* format, ...);
+  void vprintf(const char* format, va_list args);
+
+  // conversions without locale & format parsing
+  void appendInteger(uint64_t value, bool negative);
+  void appendFloat(double value);
+  void appendPointer(const void* pointer);
+
+  void reserve(size_t capacity)
+  {
+    if (capacity > capacity_)
+      grow(capacity);
+  }
+
+ private:
+  void grow(size_t capacity);
+
+ private:
+  char                    fixed_[FIXED_SIZE];
+  std::unique_ptr<char[]> extend_;
+  char*                   data_     = fixed_;
+  size_t                  capacity_ = FIXED_SIZE;
+  size_t                  size_     = 0;
+};
+
+namespace formatter {
+
+// Format string parsed at compile-time ("{}" : argument, "{{" "}}" : brace)
+// N : length of the format string
+template <size_t N>
+struct Parsed {
+  char   text[N + 1]       = {};  // literal text (escapes removed)
+  size_t offset[N / 2 + 2] = {};  // text of piece i : offset[i] ~ offset[i+1]
+  size_t count             = 0;   // number of "{}"
+  bool   valid             = true;
+
+  constexpr explicit Parsed(std::string_view fmt)
+  {
+    size_t length = 0;
+    for (size_t i = 0; i < fmt.size(); ++i) {
+      if (fmt[i] == '{') {
+        if (i + 1 < fmt.size() && fmt[i + 1] == '{') {
+          text[length++] = '{';
+          ++i;
+        }
+        else if (i + 1 < fmt.size() && fmt[i + 1] == '}') {
+          offset[++count] = length;
+          ++i;
+        }
+        else {
+          valid = false;  // unsupported specifier or unmatched '{'
+          return;
+        }
+      }
+      else if (fmt[i] == '}') {
+        if (i + 1 < fmt.size() && fmt[i + 1] == '}') {
+          text[length++] = '}';
+          ++i;
+        }
+        else {
+          valid = false;  // unmatched '}'
+          return;
+        }
+      }
+      else {
+        text[length++] = fmt[i];
+      }
+    }
+    offset[count + 1] = length;
+  }
+};
+
+// argument types with a dedicated conversion
+template <typename T>
+constexpr bool isSupported()
+{
+  using U = std::decay_t<T>;
+  return std::is_arithmetic_v<U> || std::is_pointer_v<U> ||
+         std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view>;
+}
+
+template <typename T>
+void write(FormatBuffer& buffer, const T& value)
+{
+  using U = std::decay_t<T>;
+  if constexpr (std::is_same_v<U, bool>) {
+    if (value)
+      buffer.append("true", 4);
+    else
+      buffer.append("false", 5);
+  }
+  else if constexpr (std::is_same_v<U, char>) {
+    buffer.append(value);
+  }
+  else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+    auto magnitude = static_cast<uint64_t>(value);
+    buffer.appendInteger(value < 0 ? 0 - magnitude : magnitude, value < 0);
+  }
+  else if constexpr (std::is_integral_v<U>) {
+    buffer.appendInteger(static_cast<uint64_t>(value), false);
+  }
+  else if constexpr (std::is_floating_point_v<U>) {
+    buffer.appendFloat(static_cast<double>(value));
+  }
+  else if constexpr (std::is_array_v<T>) {
+    buffer.append(value, strnlen(value, sizeof(T)));  // string literal
+  }
+  else if constexpr (std::is_same_v<U, const char*> ||
+                     std::is_same_v<U, char*>) {
+    if (value)
+      buffer.append(value, strlen(value));
+    else
+      buffer.append("(null)", 6);
+  }
+  else if constexpr (std::is_pointer_v<U>) {
+    buffer.appendPointer(static_cast<const void*>(value));
+  }
+  else {
+    buffer.append(value.data(), value.size());
+  }
+}
+
+template <typename S, typename Tuple, size_t... I>
+void formatTo(FormatBuffer& buffer, const Tuple& args,
+              std::index_sequence<I...>)
+{
+  static constexpr Parsed<S::value().size()> parsed(S::value());
+
+  buffer.append(parsed.text, parsed.offset[1]);
+  ((write(buffer, std::get<I>(args)),
+    buffer.append(parsed.text + parsed.offset[I + 1],
+                  parsed.offset[I + 2] - parsed.offset[I + 1])),
+   ...);
+}
+
+// append the formatted text (placeholders & argument types checked at build)
+template <typename S, typename... Args>
+void formatTo(FormatBuffer& buffer, const std::tuple<const Args&...>& args)
+{
+  constexpr Parsed<S::value().size()> parsed(S::value());
+  static_assert(parsed.valid, "log format : only \"{}\" is supported "
+                              "(use \"{{\" and \"}}\" for braces)");
+  static_assert(parsed.count == sizeof...(Args),
+                "log format : number of \"{}\" and arguments differ");
+  static_assert((isSupported<Args>() && ...),
+                "log format : unsupported argument type (cast enum or "
+                "convert the object to a string)");
+
+  if constexpr (parsed.valid && parsed.count == sizeof...(Args))
+    formatTo<S>(buffer, args, std::index_sequence_for<Args...>{});
+}
+
+// base of the RS_FMT string types
+struct String {};
+
+template <typename S>
+constexpr bool isString = std::is_base_of_v<String, S>;
+
+}  // namespace formatter
+
+// Structured field : logger.info("request done", kv("latency_us", x))
+// (refers to the value, used within the logging statement only)
+template <typename T>
+struct KeyValue {
+  const char* key;
+  const T&    value;
+};
+
+template <typename T>
+KeyValue<T> kv(const char* key, const T& value)
+{
+  return { key, value };
+}
+
+namespace formatter {
+
+// Encoded field list of a record (shared by the text, JSON & logfmt output)
+//   [kind 'n'|'s'][key length:2][key][value length:4][value] ...
+struct Field {
+  bool             number;  // number or bool (not quoted)
+  std::string_view key;
+  std::string_view value;
+};
+
+template <typename T>
+void appendField(FormatBuffer& fields, const KeyValue<T>& field)
+{
+  using U = std::decay_t<T>;
+  static_assert(isSupported<T>(), "log field : unsupported value type (cast "
+                                  "enum or convert the object to a string)");
+
+  const bool number = std::is_arithmetic_v<U> && !std::is_same_v<U, char>;
+  const auto key    = static_cast<uint16_t>(strlen(field.key));
+  fields.append(number ? 'n' : 's');
+  fields.append(reinterpret_cast<const char*>(&key), sizeof(key));
+  fields.append(field.key, key);
+
+  // value is converted in place, its length is patched afterwards
+  uint32_t length = 0;
+  size_t   offset = fields.size();
+  fields.append(reinterpret_cast<const char*>(&length), sizeof(length));
+  write(fields, field.value);
+  length = static_cast<uint32_t>(fields.size() - offset - sizeof(length));
+  memcpy(fields.data() + offset, &length, sizeof(length));
+}
+
+// read the next field (false : end of the list)
+inline bool readField(const char*& data, const char* end, Field& field)
+{
+  if (data >= end)
+    return false;
+
+  uint16_t key;
+  uint32_t value;
+  field.number = (*data++ == 'n');
+  memcpy(&key, data, sizeof(key));
+  data += sizeof(key);
+  field.key = std::string_view(data, key);
+  data += key;
+  memcpy(&value, data, sizeof(value));
+  data += sizeof(value);
+  field.value = std::string_view(data, value);
+  data += value;
+  return true;
+}
+
+// escaped output of text & fields
+void appendJsonString(FormatBuffer& buffer, std::string_view text);
+void appendLogfmtValue(FormatBuffer& buffer, std::string_view text);
+void appendJsonFields(FormatBuffer& buffer, const char* fields, size_t length);
+void appendLogfmtFields(FormatBuffer& buffer, const char* fields,
+                        size_t length);
+
+}  // namespace formatter
+}  // namespace rs
+
+// Compile-time format string : logger.info(RS_FMT("x={} y={}"), x, y)
+// clang-format off
+#define RS_FMT(str) [] { struct __rs_format_string : rs::formatter::String { static constexpr std::string_view value() { return str; } }; return __rs_format_string{}; }()
+// clang-format on
+
+#endif  //__ROWEN_SDK_CORE_LOGFORMAT_HPP__
@@ -0,0 +1,258 @@
+#ifndef __ROWEN_SDK_CORE_LOGSINK_HPP__
+#define __ROWEN_SDK_CORE_LOGSINK_HPP__
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "logArchiver.hpp"
+#include "logFile.hpp"
+#include "logFlusher.hpp"
+#include "logIndex.hpp"
+#include "logger.hpp"
+#include "sharedRing.hpp"
+
+namespace rs {
+
+// formatted log record : content = [header][body][tail]
+// (body = message & " key=value" text of the structured fields)
+struct LogRecord {
+  Logger::Level    level;
+  bool             raw;
+  const struct tm* tm;
+  int              millisecond;
+  const char*      file;
+  int              line;
+  const char*      content;
+  size_t           header_length;  // end of "[time] [LEVEL] "
+  size_t           body_length;    // end of message
+  size_t           length;         // end of "   ... (file: line)\n"
+  size_t           message_length;  // end of message without fields
+  const char*      fields;          // encoded fields (formatter::Field)
+  size_t           fields_length;
+};
+
+// Log output destination
+class LogSink {
+ public:
+  enum class Format {
+    FULL,     // [time] [LEVEL] message   ... (file: line)
+    SHORT,    // [time] [LEVEL] message
+    MESSAGE,  // message
+    JSON,     // {"time":..,"level":..,"msg":..,"file":..,"line":..,fields}
+    LOGFMT,   // time=.. level=.. msg=.. file=.. line=.. key=value
+  };
+
+  // rendered text (newline : append a line feed after data, JSON & logfmt
+  // are rendered in a per-thread buffer valid until the next call)
+  struct Text {
+    const char* data;
+    size_t      length;
+    bool        newline;
+  };
+
+ public:
+  explicit LogSink(Format format = Format::FULL) : format_(format) {}
+  virtual ~LogSink() = default;
+
+  // write levels from FATAL to the specified level
+  void setLevel(Logger::Level level);
+
+  // enable or disable a single level
+  void setLevelEnabled(Logger::Level level, bool enable);
+
+  bool accepts(Logger::Level level) const
+  {
+    return levels_.load(std::memory_order_relaxed) &
+           (1u << static_cast<int>(level));
+  }
+  uint32_t levels() const { return levels_.load(std::memory_order_relaxed); }
+
+  // (may be changed while logging : configuration reload)
+  void   setFormat(Format format) { format_.store(format); }
+  Format format() const { return format_.load(std::memory_order_relaxed); }
+
+  // blocking sinks are written by the writer thread in asynchronous mode,
+  // non-blocking sinks are always written from the logging thread
+  virtual bool blocking() const { return true; }
+
+  virtual void write(const LogRecord& record) = 0;
+  virtual void flush() {}
+
+ protected:
+  Text text(const LogRecord& record) const;
+
+ private:
+  std::atomic<uint32_t> levels_ = { 0 };
+  std::atomic<Format>   format_;
+};
+
+// standard output (fd 1) or error (fd 2) written with write(2), no stdio
+//  - terminal    : line buffered (every record is written at once)
+//  - pipe & file : block buffered, written when full, every second, on
+//                  ERROR & FATAL and on flush
+// (sinks on the same fd share one buffer, sized by the first sink, so the
+//  records of every logger instance keep their order)
+class ConsoleSink : public LogSink {
+ public:
+  explicit ConsoleSink(int fd = 1, size_t buffer_size = 65536);
+  ~ConsoleSink();
+
+  // ANSI color per level (terminal only, default : disabled)
+  void setColor(bool enable) { color_.store(enable); }
+
+  // write every record at once (default : on a terminal), otherwise the
+  // buffer is written when full, on ERROR or above, or once per second
+  void setLineBuffered(bool enable) { line_buffered_.store(enable); }
+
+  bool isTerminal() const { return terminal_; }
+
+  void write(const LogRecord& record) override;
+  void flush() override;
+
+ private:
+  struct Output;  // buffer of a file descriptor
+
+  std::shared_ptr<Output> output_;
+  bool                    terminal_;
+  std::atomic<bool>       color_         = { false };
+  std::atomic<bool>       line_buffered_ = { false };
+};
+
+// hourly rotating file ({directory}/YYYY_MM_DD/YYYY_MM_DD-HH-NN.txt)
+class FileSink : public LogSink {
+ public:
+  // directory is created if not exist (empty : set later)
+  explicit FileSink(const std::string& directory = "");
+  ~FileSink();
+
+  void setDirectory(const std::string& directory);
+  void setSizeLimit(size_t bytes);
+  void setPreallocate(size_t bytes);
+
+  // gzip rotated files in the background (zlib build only)
+  void setCompression(bool enable);
+
+  // delete the oldest day directories above the budget (0 : unlimited)
+  void setRetention(uint64_t bytes);
+
+  // write a sidecar index ({file}.idx) sampled every `records` records
+  // (0 : disabled)
+  void setIndex(uint32_t records);
+
+  void write(const LogRecord& record) override;
+  void flush() override;
+
+ private:
+  std::mutex  mutex_;
+  std::string directory_;
+  uint64_t    retention_      = 0;
+  uint32_t    index_sequence_ = 0;  // file_.sequence() of the open index
+  LogArchiver archiver_;  // outlives file_ (receives its last file)
+  LogIndex    index_;     // outlives file_ (committed on its last flush)
+  LogFile     file_;
+};
+
+// lock-free in-memory ring of the most recent records (older are overwritten)
+class RingSink : public LogSink {
+ public:
+  explicit RingSink(size_t capacity = 1024, size_t record_size = 256);
+
+  bool blocking() const override { return false; }
+  void write(const LogRecord& record) override;
+
+  // copy of the stored records (oldest first)
+  std::vector<std::string> snapshot() const;
+
+  // write the stored records to the file descriptor (oldest first),
+  // async-signal-safe : no allocation & no lock (one dump at a time, a
+  // concurrent call returns at once)
+  void dump(int fd) const;
+
+  size_t capacity() const { return capacity_; }
+
+ private:
+  struct Slot {
+    std::atomic<uint64_t> sequence = { 0 };  // odd : writing
+    std::atomic<uint32_t> length   = { 0 };
+  };
+
+  size_t                    capacity_;
+  size_t                    record_size_;
+  std::unique_ptr<Slot[]>   slots_;
+  std::unique_ptr<char[]>   data_;
+  std::unique_ptr<char[]>   scratch_;  // dump : copy checked before write
+  std::atomic<uint64_t>     position_ = { 0 };
+  mutable std::atomic<bool> dumping_  = { false };
+};
+
+// memory-mapped file segments ({directory}/YYYY_MM_DD/YYYY_MM_DD-HH-NN.seg),
+// records are copied into the mapping without lock or system call and are
+// kept by the kernel even if the process crashes
+class MappedFileSink : public LogSink {
+ public:
+  explicit MappedFileSink(const std::string& directory,
+                          size_t             segment_size = 16 * 1024 * 1024);
+  ~MappedFileSink();
+
+  bool blocking() const override { return false; }
+  void write(const LogRecord& record) override;
+  void flush() override;
+
+ private:
+  struct Segment;
+
+  bool roll(Segment* full, const struct tm& tm);
+  void close(Segment* segment);
+
+ private:
+  std::string directory_;
+  size_t      segment_size_;
+
+  std::mutex                            mutex_;  // rolling only
+  std::atomic<Segment*>                 current_ = { nullptr };
+  std::vector<std::unique_ptr<Segment>> segments_;
+  int                                   index_ = 0;
+};
+
+// local datagram socket (Unix domain), records are dropped if nobody listens
+class SocketSink : public LogSink {
+ public:
+  explicit SocketSink(const std::string& path);
+  ~SocketSink();
+
+  bool blocking() const override { return false; }
+  void write(const LogRecord& record) override;
+
+  uint64_t dropped() const { return dropped_.load(); }
+
+ private:
+  int                   fd_ = -1;
+  std::string           path_;
+  std::atomic<uint64_t> dropped_ = { 0 };
+};
+
+// records pushed to a POSIX shared memory ring, written to the rotating files
+// by a single collector (LogCollector) : several processes share one set of
+// file handles in a global order without cross-process locks
+class SharedRingSink : public LogSink {
+ public:
+  explicit SharedRingSink(const std::string& name = "/rowen-log",
+                          size_t capacity = 4096, size_t record_size = 512);
+
+  bool blocking() const override { return false; }
+  void write(const LogRecord& record) override;
+
+  bool     isOpen() const { return ring_.isOpen(); }
+  uint64_t dropped() const { return dropped_.load(); }
+
+ private:
+  SharedRing            ring_;
+  std::atomic<uint64_t> dropped_ = { 0 };
+};
+
+}  // namespace rs
+
+#endif  //__ROWEN_SDK_CORE_LOGSINK_HPP__
@@ -0,0 +1,111 @@
+#ifndef __ROWEN_SDK_CORE_LOGTHROTTLE_HPP__
+#define __ROWEN_SDK_CORE_LOGTHROTTLE_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace rs {
+
+// Rate limit & duplicate suppression state of a single log statement
+// (one static instance per logger_* call-site, lock-free)
+class LogThrottle {
+ public:
+  enum class Mode {
+    NONE,          // write all records
+    TOKEN_BUCKET,  // `rate` records per second, bursts up to `burst`
+    SAMPLING,      // write 1 of every `rate` records
+  };
+
+  // global policy (applied to every call-site)
+  static void configure(Mode mode, uint32_t rate, uint32_t burst);
+  static void setRepeatInterval(uint32_t interval_ms);
+
+  // check before formatting (false : suppressed)
+  bool pass()
+  {
+    switch (mode_.load(std::memory_order_relaxed)) {
+      case Mode::TOKEN_BUCKET:
+        if (acquireToken())
+          return true;
+        break;
+      case Mode::SAMPLING: {
+        auto count = count_.fetch_add(1, std::memory_order_relaxed);
+        if (count % sampling_.load(std::memory_order_relaxed) == 0)
+          return true;
+      } break;
+      default:
+        return true;
+    }
+    suppressed_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  // duplicate suppression is on (check before hashing the message)
+  static bool repeatEnabled()
+  {
+    return repeat_ns_.load(std::memory_order_relaxed) > 0;
+  }
+
+  // check after formatting (false : same message as the last one)
+  bool unique(uint64_t hash, int64_t now_ns);
+
+  // first repeat since the last report (the call-site is then reported once
+  // the interval is over, even if no other message follows)
+  bool markPending()
+  {
+    return pending_.load(std::memory_order_relaxed) == false &&
+           pending_.exchange(true) == false;
+  }
+  void clearPending() { pending_.store(false, std::memory_order_relaxed); }
+
+  // the repeat interval of the last written message is over
+  bool repeatExpired(int64_t now_ns) const
+  {
+    return now_ns >= repeat_until_.load(std::memory_order_relaxed);
+  }
+
+  // counters since the last written record of this call-site (no write
+  // when nothing was counted)
+  uint32_t takeSuppressed() { return take(suppressed_); }
+  uint32_t takeRepeated() { return take(repeated_); }
+
+  static int64_t now()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+ private:
+  bool acquireToken();
+
+  static uint32_t take(std::atomic<uint32_t>& counter)
+  {
+    if (counter.load(std::memory_order_relaxed) == 0)
+      return 0;
+    return counter.exchange(0);
+  }
+
+ private:
+  // token bucket (virtual scheduling : time when the bucket is full again)
+  std::atomic<int64_t>  full_at_ns_ = { 0 };
+  std::atomic<uint64_t> count_      = { 0 };
+  std::atomic<uint32_t> suppressed_ = { 0 };
+
+  // duplicate suppression
+  std::atomic<uint64_t> last_hash_    = { 0 };
+  std::atomic<int64_t>  repeat_until_ = { 0 };
+  std::atomic<uint32_t> repeated_     = { 0 };
+  std::atomic<bool>     pending_      = { false };
+
+  static std::atomic<Mode>     mode_;
+  static std::atomic<int64_t>  interval_ns_;  // token bucket : 1 token
+  static std::atomic<int64_t>  capacity_ns_;  // token bucket : burst tokens
+  static std::atomic<uint32_t> sampling_;
+  static std::atomic<int64_t>  repeat_ns_;
+};
+
+}  // namespace rs
+
+#endif  //__ROWEN_SDK_CORE_LOGTHROTTLE_HPP__
@@ -0,0 +1,84 @@
+#ifndef __ROWEN_SDK_CORE_SHAREDRING_HPP__
+#define __ROWEN_SDK_CORE_SHAREDRING_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace rs {
+
+// Lock-free multi-process record ring in POSIX shared memory (/dev/shm)
+//  - producers (any process) : reserve a ticket, claim, copy, publish
+//    (no lock)
+//  - consumer (one collector) : read in ticket order (global order)
+class SharedRing {
+ public:
+  // record metadata (text, encoded fields & file name follow in the slot)
+  struct Entry {
+    uint8_t  level;
+    uint8_t  raw;
+    uint16_t millisecond;
+    uint16_t year;  // local time of the record
+    uint8_t  month, day, hour, minute, second;
+    uint8_t  reserved;
+    uint32_t header_length;
+    uint32_t body_length;
+    uint32_t message_length;
+    uint32_t length;
+    int32_t  line;
+    uint32_t fields_length;  // 0 : none (or dropped for a short slot)
+    uint32_t file_length;    // 0 : none (or dropped for a short slot)
+  };
+
+ public:
+  SharedRing() = default;
+  ~SharedRing();
+
+  SharedRing(const SharedRing&)            = delete;
+  SharedRing& operator=(const SharedRing&) = delete;
+
+  // create or attach (capacity : power of 2, the creator's size is used)
+  bool open(const std::string& name, size_t capacity = 4096,
+            size_t record_size = 512);
+  void close();
+
+  bool   isOpen() const { return header_ != nullptr; }
+  size_t recordSize() const;
+
+  // false : ring is full (record is dropped), text is truncated to the slot
+  // (fields & file are kept if they fit in half of the slot)
+  bool push(const Entry& entry, const char* text, const char* fields = nullptr,
+            const char* file = nullptr);
+
+  // next record in ticket order (false : empty), `text` is valid until the
+  // next call, fields & file (NUL terminated) follow it
+  bool pop(Entry& entry, const char*& text);
+
+  // single collector election : false if another live process holds it
+  // (taken over when the holder has exited)
+  bool acquireConsumer();
+  void releaseConsumer();
+
+  // remove the shared memory object (mapped rings stay valid)
+  static void unlink(const std::string& name);
+
+ private:
+  struct Header;
+  struct Slot;
+
+  Slot* slot(uint64_t ticket) const;
+
+ private:
+  Header* header_ = nullptr;
+  size_t  size_   = 0;
+
+  // consumer state
+  uint64_t pending_        = UINT64_MAX;  // slot released on the next pop
+  uint64_t stalled_ticket_ = UINT64_MAX;
+  int64_t  stalled_since_  = 0;
+};
+
+}  // namespace rs
+
+#endif  //__ROWEN_SDK_CORE_SHAREDRING_HPP__
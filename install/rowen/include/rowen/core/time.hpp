@@ -0,0 +1,225 @@
+#ifndef __ROWEN_SDK_CORE_TIME_HPP__
+#define __ROWEN_SDK_CORE_TIME_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+using namespace std::chrono_literals;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::chrono::nanoseconds;
+using std::chrono::seconds;
+
+namespace rs {
+
+class Time {
+  using Tick    = uint64_t;
+  using Value   = uint64_t;
+  using Format  = std::string;
+  using CFormat = const std::string&;
+
+ public:
+  enum class Resolution : int {
+    SEC,    // Second
+    MILLI,  // Milli second
+    MICRO,  // Micro second
+    NANO    // Nano second
+  };
+
+  // tick source (ticks of different clocks are not comparable)
+  enum class Clock : int {
+    SYSTEM,  // wall clock, may jump with NTP (default)
+    STEADY,  // monotonic
+    COARSE,  // monotonic, updated every kernel tick (Linux, 1 ~ 4 ms)
+    TSC      // monotonic CPU counter (invariant TSC, cntvct_el0), calibrated
+             // on the steady clock at the first use
+  };
+
+  // Stopwatch handle : the key is looked up once (Time::timer), start &
+  // elapse are lock-free atomics usable from any thread (the slot is shared
+  // with the key until removeTimer, then owned by the handles left)
+  class Timer {
+   public:
+    Timer() = default;
+
+    void start()
+    {
+      if (slot_)
+        slot_->store(tick(), std::memory_order_relaxed);
+    }
+
+    // elapsed tick count since start (0 : not started or invalid handle)
+    Tick elapse() const
+    {
+      if (slot_ == nullptr)
+        return 0;
+      auto start = slot_->load(std::memory_order_relaxed);
+      return (start == STOPPED) ? 0 : tick() - start;
+    }
+
+    // back to the not started state
+    void stop()
+    {
+      if (slot_)
+        slot_->store(STOPPED, std::memory_order_relaxed);
+    }
+
+    bool isValid() const { return slot_ != nullptr; }
+
+   private:
+    friend class Time;
+    static constexpr Tick STOPPED = UINT64_MAX;
+
+    explicit Timer(std::shared_ptr<std::atomic<Tick>> slot)
+        : slot_(std::move(slot))
+    {
+    }
+
+    std::shared_ptr<std::atomic<Tick>> slot_;
+  };
+
+ public:
+  //////////////////////////
+  // Options & Control
+  static void setResolution(Resolution register_t = Resolution::MILLI);
+
+  // false : not available on this CPU or system (STEADY is used)
+  static bool  setClock(Clock clock);
+  static Clock clock();
+  //////////////////////////
+
+  // get time unit(ms, ns, us etc.)
+  static const char* unit();
+
+  // get tick count of the clock (no branch on the resolution)
+  static Tick tick()
+  {
+    return tick_source_.load(std::memory_order_acquire)->function();
+  }
+
+  // stopwatch handle of the key (created on the first call, kept until
+  // removeTimer)
+  static Timer timer(const std::string& key);
+
+  // set or update start time (key lookup : keep the handle in hot paths)
+  static void setTimer(const std::string& key);
+
+  // remove the key (handles of the key keep working, detached from it)
+  static void removeTimer(const std::string& key);
+
+  // get elapsed tick count
+  static Tick elapse(const std::string& key);
+
+  // check if the specified time has passed (boolean)
+  template <typename __literals>
+  static bool elapse(__literals target, Tick start, Tick end = 0)
+  {
+    auto source = tick_source_.load(std::memory_order_acquire);
+    if (end == 0)
+      end = source->function();
+    return (end - start > literalToTick(target, *source));
+  }
+
+  // get time-string in the specified format
+  static Format timeString(CFormat format = "%F %T", Tick tick = 0,
+                           bool ext = false);
+
+  // get time-string in the fixed format (YYYY-MM-DD HH:mm:SS)
+  static Format timeString(Tick tick, bool ext = false);
+
+  // convert second to current resolution tick count
+  static Tick casting(long double second);
+
+  // Converts the current resolution tick count to the specified resolution
+  template <typename resolution>
+  static Tick casting(Tick time)
+  {
+    return static_cast<Time::Tick>((time * resolutionTick<resolution>()) /
+                                   resolutionTick());
+  }
+
+  // running interval functions
+  template <typename literals, typename callable, typename... Args>
+  static void runInterval(literals interval, std::string key, callable&& func,
+                          Args&&... args)
+  {
+    auto source = tick_source_.load(std::memory_order_acquire);
+    auto time   = source->function();
+    auto iter   = interval_map_.find(key);
+    if (iter != interval_map_.end()) {
+      if (time - iter->second > literalToTick(interval, *source)) {
+        func(std::forward<args>(args)...);
+        iter->second = time;
+      }
+    }
+    else {
+      interval_map_.insert({ key, time });
+    }
+  }
+
+  template <typename literals>
+  static void sleep(literals time)
+  {
+    std::this_thread::sleep_for(time);
+  }
+
+ private:
+  // clock & resolution, published together (readers never mix the two)
+  struct TickSource {
+    Tick (*function)();
+    Tick       nanoseconds;  // nanoseconds per tick
+    Clock      clock;
+    Resolution resolution;
+  };
+
+  // tick count to string
+  static Format tickToString(Tick tick, bool ext, CFormat format);
+
+  template <typename resolution>
+  static Format _tickToString(Tick tick, bool ext, CFormat format);
+
+  static long double resolutionTick();
+
+  template <typename resolution>
+  static Tick resolutionTick()
+  {
+    if (std::is_same<resolution, seconds>())
+      return 1;
+    if (std::is_same<resolution, milliseconds>())
+      return 1000;
+    if (std::is_same<resolution, microseconds>())
+      return 1000000;
+    if (std::is_same<resolution, nanoseconds>())
+      return 1000000000;
+    return 1;
+  }
+
+  // get adjust integer value (based on current resolution)
+  template <typename literals>
+  static Tick literalToTick(literals time, const TickSource& source)
+  {
+    using std::chrono::duration_cast;
+    return static_cast<Tick>(duration_cast<nanoseconds>(time).count()) /
+           source.nanoseconds;
+  }
+
+  // tick of the clock to the system clock (time string)
+  static Tick toSystemTick(Tick tick, const TickSource& source);
+
+  static void updateTickSource(Clock clock, Resolution resolution);
+
+ private:
+  static std::unordered_map<std::string, Tick> interval_map_;
+  static const TickSource                      tick_sources_[4][4];
+  static std::atomic<const TickSource*>        tick_source_;
+};
+
+};  // namespace rs
+
+#endif  //__ROWEN_SDK_CORE_TIME_HPP__
\ No newline at end of file
@@ -0,0 +1,117 @@
+#ifndef __ROWEN_SDK_UTIL_PROFILER_HPP__
+#define __ROWEN_SDK_UTIL_PROFILER_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace rs {
+
+namespace profiler {
+struct ThreadData;
+}  // namespace profiler
+
+// Scoped profiling zones : RS_PROFILE_SCOPE("decode")
+//  - zones are timed on the calling thread and pushed to its own lock-free
+//    ring (no lock, no allocation after the first zone of a thread)
+//  - a collector thread drains the rings into log-bucketed histograms per
+//    zone & parent zone (count, mean, p50/p99/max, inclusive & self time)
+//  - reports go to rs::Logger (periodic or on demand) or to a Chrome trace
+//    JSON file (chrome://tracing, Perfetto)
+class Profiler {
+ public:
+  // call-site of a zone (static, name must outlive the program)
+  struct Site {
+    constexpr Site(const char* name, const char* file, int line)
+        : name(name), file(file), line(line)
+    {
+    }
+
+    const char*           name;
+    const char*           file;
+    int                   line;
+    std::atomic<uint32_t> id = { 0 };  // registered on the first use
+  };
+
+  // RAII zone (nothing is measured while the profiler is disabled)
+  class Zone {
+   public:
+    explicit Zone(Site& site)
+    {
+      if (enabled_.load(std::memory_order_relaxed))
+        begin(site);
+    }
+    ~Zone()
+    {
+      if (thread_)
+        end();
+    }
+
+    Zone(const Zone&)            = delete;
+    Zone& operator=(const Zone&) = delete;
+
+   private:
+    void begin(Site& site);
+    void end();
+
+    profiler::ThreadData* thread_ = nullptr;
+  };
+
+ public:
+  // start or stop profiling (the collector thread runs while enabled)
+  static void setEnabled(bool enable);
+  static bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  // log a report and reset the statistics every interval (0 : disabled)
+  static void setReportInterval(uint32_t interval_ms);
+
+  // keep the latest zones for writeChromeTrace (0 : disabled, default)
+  static void setTraceCapacity(size_t events);
+
+  // zone ring of each thread (applies to threads started afterwards)
+  static void setThreadCapacity(size_t events);
+
+  // log the statistics since the last reset through rs::Logger (INFO)
+  static void report(bool reset = false);
+
+  // report text (same as the logged report)
+  static std::string reportText(bool reset = false);
+
+  // write the kept zones as Chrome trace events (false : cannot write)
+  static bool writeChromeTrace(const std::string& path);
+
+  // clear the statistics & kept zones
+  static void reset();
+
+  // zones lost because a thread ring was full
+  static uint64_t dropped();
+
+  // steady clock nanoseconds
+  static uint64_t now()
+  {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+  }
+
+ private:
+  static std::atomic<bool> enabled_;
+};
+
+}  // namespace rs
+
+// clang-format off
+#define __ROWEN_PROFILE_CONCAT2(a, b) a##b
+#define __ROWEN_PROFILE_CONCAT(a, b)  __ROWEN_PROFILE_CONCAT2(a, b)
+
+#define RS_PROFILE_SCOPE(name) \
+  static rs::Profiler::Site __ROWEN_PROFILE_CONCAT(__rs_profile_site_, __LINE__)(name, __FILE__, __LINE__); \
+  rs::Profiler::Zone        __ROWEN_PROFILE_CONCAT(__rs_profile_zone_, __LINE__)(__ROWEN_PROFILE_CONCAT(__rs_profile_site_, __LINE__))
+
+#define RS_PROFILE_FUNCTION() RS_PROFILE_SCOPE(__func__)
+// clang-format on
+
+#endif  //__ROWEN_SDK_UTIL_PROFILER_HPP__
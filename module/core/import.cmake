@@ -14,5 +14,37 @@ setup(${CMAKE_CURRENT_LIST_DIR}/src/function.hpp)
 setup(${CMAKE_CURRENT_LIST_DIR}/src/time.hpp)
 setup(${CMAKE_CURRENT_LIST_DIR}/src/time.cpp)
 
+setup(${CMAKE_CURRENT_LIST_DIR}/src/mpscQueue.hpp)
+
+setup(${CMAKE_CURRENT_LIST_DIR}/src/logFile.hpp)
+setup(${CMAKE_CURRENT_LIST_DIR}/src/logFile.cpp)
+
+setup(${CMAKE_CURRENT_LIST_DIR}/src/logFlusher.hpp)
+setup(${CMAKE_CURRENT_LIST_DIR}/src/logFlusher.cpp)
+
+setup(${CMAKE_CURRENT_LIST_DIR}/src/logArchiver.hpp)
+setup(${CMAKE_CURRENT_LIST_DIR}/src/logArchiver.cpp)
+
+setup(${CMAKE_CURRENT_LIST_DIR}/src/logIndex.hpp)
+setup(${CMAKE_CURRENT_LIST_DIR}/src/logIndex.cpp)
+
+setup(${CMAKE_CURRENT_LIST_DIR}/src/binaryLog.hpp)
+setup(${CMAKE_CURRENT_LIST_DIR}/src/functionName.hpp)
+
+setup(${CMAKE_CURRENT_LIST_DIR}/src/logFormat.hpp)
+setup(${CMAKE_CURRENT_LIST_DIR}/src/logFormat.cpp)
+
+setup(${CMAKE_CURRENT_LIST_DIR}/src/sharedRing.hpp)
+setup(${CMAKE_CURRENT_LIST_DIR}/src/sharedRing.cpp)
+
+setup(${CMAKE_CURRENT_LIST_DIR}/src/logThrottle.hpp)
+setup(${CMAKE_CURRENT_LIST_DIR}/src/logThrottle.cpp)
+
 setup(${CMAKE_CURRENT_LIST_DIR}/src/logger.hpp)
-setup(${CMAKE_CURRENT_LIST_DIR}/src/logger.cpp)
\ No newline at end of file
+setup(${CMAKE_CURRENT_LIST_DIR}/src/logger.cpp)
+
+setup(${CMAKE_CURRENT_LIST_DIR}/src/logSink.hpp)
+setup(${CMAKE_CURRENT_LIST_DIR}/src/logSink.cpp)
+
+setup(${CMAKE_CURRENT_LIST_DIR}/src/logCollector.hpp)
+setup(${CMAKE_CURRENT_LIST_DIR}/src/logCollector.cpp)
\ No newline at end of file
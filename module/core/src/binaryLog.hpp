@@ -0,0 +1,123 @@
+#ifndef __ROWEN_SDK_CORE_BINARYLOG_HPP__
+#define __ROWEN_SDK_CORE_BINARYLOG_HPP__
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace rs {
+namespace binlog {
+
+// File layout (host byte order)
+//   FILE_HEADER : kind(1) "RSBLOG1"(7)
+//   FORMAT      : kind(1) id(4) level(1) line(4) fmt_len(2) file_len(2)
+//                 fmt(fmt_len) file(file_len)
+//   RECORD      : kind(1) id(4) time_ns(8) payload_len(2) payload
+//   payload     : { arg_type(1) value } ...
+enum class Kind : uint8_t { FILE_HEADER = 0xB0, FORMAT = 0xB1, RECORD = 0xB2 };
+enum class Arg : uint8_t { I32 = 1, I64, U32, U64, F64, STR, PTR };
+
+constexpr char   MAGIC[]     = "RSBLOG1";
+constexpr size_t MAX_PAYLOAD = 4096;
+
+// static call-site information (one per logger_bin_* statement)
+struct Format {
+  Format(int level, const char* fmt, const char* file, int line);
+
+  const uint32_t id;
+  const int      level;
+  const char*    fmt;
+  const char*    file;
+  const int      line;
+
+  // last file sequence the definition was written to (binary writer only)
+  mutable uint32_t file_sequence = 0;
+};
+
+// raw argument encoder (arguments are truncated when the payload is full)
+class Encoder {
+ public:
+  Encoder(char* buffer, size_t capacity) : buffer_(buffer), capacity_(capacity)
+  {
+  }
+
+  size_t size() const { return size_; }
+
+  void put(const char* value)
+  {
+    if (value == nullptr)
+      value = "(null)";
+
+    size_t length = strlen(value);
+    if (size_ + 3 > capacity_)
+      return;
+    if (length > capacity_ - size_ - 3)
+      length = capacity_ - size_ - 3;
+
+    auto len16 = static_cast<uint16_t>(length);
+    buffer_[size_++] = static_cast<char>(Arg::STR);
+    memcpy(buffer_ + size_, &len16, sizeof(len16));
+    memcpy(buffer_ + size_ + sizeof(len16), value, length);
+    size_ += sizeof(len16) + length;
+  }
+
+  void put(const std::string& value) { put(value.c_str()); }
+
+  template <typename T>
+  void put(T* value)
+  {
+    if constexpr (std::is_same<std::remove_cv_t<T>, char>::value)
+      put(static_cast<const char*>(value));
+    else
+      raw(Arg::PTR, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value)));
+  }
+
+  template <typename T>
+  std::enable_if_t<std::is_arithmetic<T>::value> put(T value)
+  {
+    if constexpr (std::is_floating_point<T>::value)
+      raw(Arg::F64, static_cast<double>(value));
+    else if constexpr (std::is_signed<T>::value && sizeof(T) <= 4)
+      raw(Arg::I32, static_cast<int32_t>(value));
+    else if constexpr (std::is_signed<T>::value)
+      raw(Arg::I64, static_cast<int64_t>(value));
+    else if constexpr (sizeof(T) <= 4)
+      raw(Arg::U32, static_cast<uint32_t>(value));
+    else
+      raw(Arg::U64, static_cast<uint64_t>(value));
+  }
+
+ private:
+  template <typename T>
+  void raw(Arg type, T value)
+  {
+    if (size_ + 1 + sizeof(T) > capacity_)
+      return;
+
+    buffer_[size_++] = static_cast<char>(type);
+    memcpy(buffer_ + size_, &value, sizeof(T));
+    size_ += sizeof(T);
+  }
+
+ private:
+  char*  buffer_;
+  size_t capacity_;
+  size_t size_ = 0;
+};
+
+// argument conversion for the text fallback (std::string to const char*)
+template <typename T>
+inline T printable(T value)
+{
+  return value;
+}
+inline const char* printable(const std::string& value)
+{
+  return value.c_str();
+}
+
+}  // namespace binlog
+}  // namespace rs
+
+#endif  //__ROWEN_SDK_CORE_BINARYLOG_HPP__
@@ -0,0 +1,138 @@
+#ifndef __ROWEN_SDK_CORE_FUNCTIONNAME_HPP__
+#define __ROWEN_SDK_CORE_FUNCTIONNAME_HPP__
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace rs {
+
+// Class or method name parsed from __PRETTY_FUNCTION__ (constexpr)
+//   "void ns::Foo::bar(int)"          -> class "Foo", method "bar()"
+//   "ns::Foo::bar()::<lambda(int)>"   -> class "Foo", method "bar()"
+class FunctionName {
+ public:
+  enum class Kind { CLASS, METHOD };
+
+  // extra capacity of the output for "(NO CLASS)" & "()"
+  static constexpr size_t PADDING = 12;
+
+  // write the name to `out` (pretty.size() + PADDING), return its length
+  static constexpr size_t parse(std::string_view pretty, Kind kind, char* out)
+  {
+    // remove lambda ("::<lambda(...)>", nested brackets included)
+    size_t length = 0;
+    for (size_t i = 0; i < pretty.size();) {
+      if (pretty.substr(i, 10) == "::<lambda(") {
+        int depth = 0;
+        for (; i < pretty.size(); ++i) {
+          if (pretty[i] == '<')
+            depth++;
+          else if (pretty[i] == '>' && --depth == 0)
+            break;
+        }
+        i++;
+        continue;
+      }
+      out[length++] = pretty[i++];
+    }
+    std::string_view func(out, length);
+
+    // find method start point
+    size_t method_start = func.find('(');
+    if (method_start == std::string_view::npos)
+      return length;
+    func = func.substr(0, method_start + 1);
+
+    size_t begin = 0, end = 0;
+    size_t colons = func.rfind("::");
+    if (kind == Kind::CLASS) {
+      if (colons == std::string_view::npos)
+        return copy("(NO CLASS)", out);
+
+      // include namespace
+      size_t colons_prev = (colons > 0) ? func.rfind("::", colons - 1)
+                                        : std::string_view::npos;
+      if (colons_prev == std::string_view::npos)
+        begin = func.rfind(' ', colons) + 1;
+      else
+        begin = colons_prev + 2;  // 2: length of "::"
+      end = colons;
+    }
+    else {
+      if (colons == std::string_view::npos)
+        begin = func.rfind(' ') + 1;
+      else
+        begin = colons + 2;
+      end = method_start;
+    }
+
+    for (size_t i = begin; i < end; ++i)
+      out[i - begin] = out[i];
+    length = end - begin;
+    if (kind == Kind::METHOD) {
+      out[length++] = '(';
+      out[length++] = ')';
+    }
+    return length;
+  }
+
+ private:
+  static constexpr size_t copy(std::string_view text, char* out)
+  {
+    for (size_t i = 0; i < text.size(); ++i)
+      out[i] = text[i];
+    return text.size();
+  }
+};
+
+// Parsed name of a call-site (T : type of __PRETTY_FUNCTION__)
+//   static constexpr StaticFunctionName<T> name(__PRETTY_FUNCTION__, kind);
+//   static const auto&                     value = name.value();
+template <typename T>
+class StaticFunctionName;
+
+// known size : parsed at compile-time into a char array
+template <size_t N>
+class StaticFunctionName<const char[N]> {
+ public:
+  constexpr StaticFunctionName(const char (&pretty)[N], FunctionName::Kind kind)
+  {
+    size_t length = FunctionName::parse(std::string_view(pretty, N - 1), kind,
+                                        name_);
+    name_[length] = '\0';
+  }
+
+  constexpr const StaticFunctionName& value() const { return *this; }
+  constexpr const char*               c_str() const { return name_; }
+
+ private:
+  char name_[N + FunctionName::PADDING] = {};
+};
+
+// unknown size (GCC gives `const char[]` inside a generic lambda of a
+// template) : parsed at runtime by value(), once per call-site
+template <>
+class StaticFunctionName<const char[]> {
+ public:
+  constexpr StaticFunctionName(const char* pretty, FunctionName::Kind kind)
+      : pretty_(pretty), kind_(kind)
+  {
+  }
+
+  std::string value() const
+  {
+    std::string_view pretty(pretty_);
+    std::string      name(pretty.size() + FunctionName::PADDING, '\0');
+    name.resize(FunctionName::parse(pretty, kind_, &name[0]));
+    return name;
+  }
+
+ private:
+  const char*        pretty_;
+  FunctionName::Kind kind_;
+};
+
+}  // namespace rs
+
+#endif  //__ROWEN_SDK_CORE_FUNCTIONNAME_HPP__
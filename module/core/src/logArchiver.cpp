@@ -0,0 +1,241 @@
+#include "logArchiver.hpp"
+
+#ifdef _WIN32
+  #include <Windows.h>
+#else
+  #include <dirent.h>
+  #include <sys/resource.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#ifdef __linux__
+  #include <sys/syscall.h>
+#endif
+
+#ifdef ROWEN_WITH_ZLIB
+  #include <zlib.h>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace rs {
+
+LogArchiver::~LogArchiver()
+{
+  {
+    std::unique_lock<std::mutex> ulock(mutex_);
+    stop_ = true;
+  }
+  convar_.notify_all();
+
+  if (thread_.joinable())
+    thread_.join();
+}
+
+bool LogArchiver::supported()
+{
+#ifdef ROWEN_WITH_ZLIB
+  return true;
+#else
+  return false;
+#endif
+}
+
+void LogArchiver::setCompression(bool enable)
+{
+  std::unique_lock<std::mutex> ulock(mutex_);
+  compression_ = enable;
+}
+
+void LogArchiver::setRetention(const std::string& directory, uint64_t bytes)
+{
+  std::unique_lock<std::mutex> ulock(mutex_);
+  directory_ = directory;
+  retention_ = bytes;
+}
+
+void LogArchiver::push(const std::string& path)
+{
+  {
+    std::unique_lock<std::mutex> ulock(mutex_);
+    if (compression_ == false && retention_ == 0)
+      return;
+
+    files_.push_back(path);
+    if (thread_.joinable() == false)
+      thread_ = std::thread(&LogArchiver::run, this);
+  }
+  convar_.notify_one();
+}
+
+void LogArchiver::run()
+{
+  // keep away from the logging & application threads
+#ifdef _WIN32
+  SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+#elif defined(__linux__)
+  // (Linux : nice value of this thread only)
+  setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 19);
+#endif
+
+  std::unique_lock<std::mutex> ulock(mutex_);
+  while (true) {
+    convar_.wait(ulock, [this] { return stop_ || files_.empty() == false; });
+    if (files_.empty())
+      break;  // stopped
+
+    auto path        = files_.front();
+    auto compression = compression_;
+    auto directory   = directory_;
+    auto retention   = retention_;
+    files_.pop_front();
+
+    ulock.unlock();
+    if (compression)
+      compress(path);
+    if (retention > 0)
+      applyRetention(directory, retention);
+    ulock.lock();
+  }
+}
+
+bool LogArchiver::compress(const std::string& path)
+{
+#ifdef ROWEN_WITH_ZLIB
+  FILE* in = fopen(path.c_str(), "rb");
+  if (in == nullptr)
+    return false;
+
+  // written to a temporary file, renamed when complete (crash-safe)
+  auto   temp = path + ".gz.tmp";
+  gzFile out  = gzopen(temp.c_str(), "wb");
+  if (out == nullptr) {
+    fclose(in);
+    return false;
+  }
+
+  std::vector<char> buffer(65536);
+  bool              success = true;
+  size_t            length;
+  while ((length = fread(buffer.data(), 1, buffer.size(), in)) > 0) {
+    if (gzwrite(out, buffer.data(), static_cast<unsigned>(length)) <= 0) {
+      success = false;
+      break;
+    }
+  }
+  fclose(in);
+
+  if (gzclose(out) != Z_OK)
+    success = false;
+
+  if (success == false || rename(temp.c_str(), (path + ".gz").c_str()) != 0) {
+    remove(temp.c_str());
+    return false;
+  }
+  remove(path.c_str());
+  remove((path + ".idx").c_str());  // offsets of the uncompressed file
+  return true;
+#else
+  (void)path;
+  return false;  // zlib is not available
+#endif
+}
+
+// day directory name : YYYY_MM_DD
+static bool isDayDirectory(const char* name)
+{
+  if (strlen(name) != 10)
+    return false;
+  for (int i = 0; i < 10; ++i) {
+    bool separator = (i == 4 || i == 7);
+    if (separator ? name[i] != '_' : (name[i] < '0' || name[i] > '9'))
+      return false;
+  }
+  return true;
+}
+
+// list of regular files (full path & size)
+static void listFiles(const std::string&                             directory,
+                      std::vector<std::pair<std::string, uint64_t>>& files)
+{
+#ifdef _WIN32
+  WIN32_FIND_DATAA data;
+  HANDLE handle = FindFirstFileA((directory + "/*").c_str(), &data);
+  if (handle == INVALID_HANDLE_VALUE)
+    return;
+  do {
+    if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+      uint64_t size = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) |
+                      data.nFileSizeLow;
+      files.emplace_back(directory + "/" + data.cFileName, size);
+    }
+  } while (FindNextFileA(handle, &data));
+  FindClose(handle);
+#else
+  DIR* dir = opendir(directory.c_str());
+  if (dir == nullptr)
+    return;
+  while (struct dirent* entry = readdir(dir)) {
+    auto        path = directory + "/" + entry->d_name;
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode))
+      files.emplace_back(path, static_cast<uint64_t>(st.st_size));
+  }
+  closedir(dir);
+#endif
+}
+
+void LogArchiver::applyRetention(const std::string& directory, uint64_t bytes)
+{
+  // day directories (oldest first)
+  std::vector<std::string> days;
+#ifdef _WIN32
+  WIN32_FIND_DATAA data;
+  HANDLE handle = FindFirstFileA((directory + "/*").c_str(), &data);
+  if (handle != INVALID_HANDLE_VALUE) {
+    do {
+      if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) &&
+          isDayDirectory(data.cFileName))
+        days.push_back(data.cFileName);
+    } while (FindNextFileA(handle, &data));
+    FindClose(handle);
+  }
+#else
+  if (DIR* dir = opendir(directory.c_str())) {
+    while (struct dirent* entry = readdir(dir)) {
+      if (isDayDirectory(entry->d_name))
+        days.push_back(entry->d_name);
+    }
+    closedir(dir);
+  }
+#endif
+  std::sort(days.begin(), days.end());
+
+  std::vector<std::vector<std::pair<std::string, uint64_t>>> files(days.size());
+  std::vector<uint64_t> sizes(days.size(), 0);
+  uint64_t              total = 0;
+  for (size_t i = 0; i < days.size(); ++i) {
+    listFiles(directory + "/" + days[i], files[i]);
+    for (auto& file : files[i])
+      sizes[i] += file.second;
+    total += sizes[i];
+  }
+
+  // the latest day (being written) is always kept
+  for (size_t i = 0; i + 1 < days.size() && total > bytes; ++i) {
+    for (auto& file : files[i])
+      remove(file.first.c_str());
+#ifdef _WIN32
+    RemoveDirectoryA((directory + "/" + days[i]).c_str());
+#else
+    rmdir((directory + "/" + days[i]).c_str());
+#endif
+    total -= sizes[i];
+  }
+}
+
+}  // namespace rs
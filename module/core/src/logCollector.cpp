@@ -0,0 +1,102 @@
+#include "logCollector.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace rs {
+
+LogCollector::LogCollector(const std::string& name, size_t capacity,
+                           size_t record_size)
+{
+  ring_.open(name, capacity, record_size);
+}
+
+LogCollector::~LogCollector()
+{
+  stop();
+}
+
+bool LogCollector::start(const std::string& directory)
+{
+  if (running_ || ring_.acquireConsumer() == false)
+    return false;
+
+  LogFile::makeDirectory(directory);
+  file_->setDirectory(directory);
+
+  running_ = true;
+  thread_  = std::thread(&LogCollector::run, this);
+  return true;
+}
+
+void LogCollector::stop()
+{
+  if (running_.exchange(false) == false)
+    return;
+
+  if (thread_.joinable())
+    thread_.join();
+
+  collect();  // remaining records
+  file_->flush();
+  ring_.releaseConsumer();
+}
+
+size_t LogCollector::collect()
+{
+  SharedRing::Entry entry;
+  const char*       text;
+  size_t            count = 0;
+  while (ring_.pop(entry, text)) {
+    struct tm tm = {};
+    tm.tm_year   = entry.year - 1900;
+    tm.tm_mon    = entry.month - 1;
+    tm.tm_mday   = entry.day;
+    tm.tm_hour   = entry.hour;
+    tm.tm_min    = entry.minute;
+    tm.tm_sec    = entry.second;
+
+    // (lengths are limited to the text truncated to the slot)
+    const size_t length = entry.length;
+    const char*  fields = text + length;
+    const char*  file   = fields + entry.fields_length;
+    LogRecord    record = {
+      static_cast<Logger::Level>(entry.level),
+      entry.raw != 0,
+      &tm,
+      entry.millisecond,
+      entry.file_length > 0 ? file : nullptr,
+      entry.line,
+      text,
+      std::min<size_t>(entry.header_length, length),
+      std::min<size_t>(entry.body_length, length),
+      length,
+      std::min<size_t>(entry.message_length, length),
+      entry.fields_length > 0 ? fields : nullptr,
+      entry.fields_length,
+    };
+    file_->write(record);
+    count++;
+  }
+
+  collected_.fetch_add(count, std::memory_order_relaxed);
+  return count;
+}
+
+void LogCollector::run()
+{
+  // polling : producers never wait for the collector (no cross-process wake)
+  int idle = 0;
+  while (running_.load(std::memory_order_relaxed)) {
+    if (collect() > 0) {
+      idle = 0;
+      continue;
+    }
+    if (idle++ == 0)
+      file_->flush();
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(std::min(idle, 10)));
+  }
+}
+
+}  // namespace rs
@@ -0,0 +1,311 @@
+#include "logFile.hpp"
+
+#ifdef _WIN32
+  #include <Windows.h>
+  #include <direct.h>
+  #include <fcntl.h>
+  #include <io.h>
+#else
+  #include <dirent.h>
+  #include <fcntl.h>
+  #include <sys/stat.h>
+  #include <sys/uio.h>
+  #include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <cstring>
+
+namespace rs {
+
+LogFile::LogFile(const char* extension, size_t buffer_size)
+    : extension_(extension),
+      buffer_(std::make_unique<char[]>(buffer_size)),
+      buffer_size_(buffer_size)
+{
+}
+
+LogFile::~LogFile()
+{
+  close();
+}
+
+void LogFile::setDirectory(const std::string& directory)
+{
+  if (directory == directory_)
+    return;
+
+  close();
+  directory_ = directory;
+}
+
+bool LogFile::prepare(const struct tm& tm, size_t length)
+{
+  if (directory_.empty())
+    return false;
+
+  if (fd_ < 0 || isRotationTime(tm)) {
+    open(tm, false);
+  }
+  else if (size_limit_ > 0 && file_size_ + buffer_used_ > 0 &&
+           file_size_ + buffer_used_ + length > size_limit_) {
+    open(tm, true);
+  }
+
+  return (fd_ >= 0);
+}
+
+void LogFile::write(const struct tm& tm, const char* data, size_t length)
+{
+  if (prepare(tm, length) == false)
+    return;
+
+  if (buffer_used_ + length > buffer_size_ && length > buffer_size_ / 2) {
+    // large record : buffered data & record in a single system call
+    flush(data, length);
+  }
+  else if (buffer_used_ + length > buffer_size_) {
+    flush();
+    memcpy(buffer_.get(), data, length);
+    buffer_used_ = length;
+  }
+  else {
+    memcpy(buffer_.get() + buffer_used_, data, length);
+    buffer_used_ += length;
+  }
+
+  // flush at least once per second
+  if (flush_sec_ != tm.tm_sec) {
+    flush_sec_ = tm.tm_sec;
+    flush();
+  }
+}
+
+void LogFile::flush()
+{
+  flush(nullptr, 0);
+}
+
+void LogFile::flush(const char* data, size_t length)
+{
+  if (fd_ < 0 || buffer_used_ + length == 0)
+    return;
+
+#ifdef _WIN32
+  if (buffer_used_ > 0)
+    file_size_ += _write(fd_, buffer_.get(),
+                         static_cast<unsigned int>(buffer_used_));
+  if (length > 0)
+    file_size_ += _write(fd_, data, static_cast<unsigned int>(length));
+#else
+  // gather write : buffer + data (continued after a partial write)
+  struct iovec iov[2];
+  int          count = 0;
+  if (buffer_used_ > 0)
+    iov[count++] = { buffer_.get(), buffer_used_ };
+  if (length > 0)
+    iov[count++] = { const_cast<char*>(data), length };
+
+  struct iovec* pending = iov;
+  while (count > 0) {
+    auto written = ::writev(fd_, pending, count);
+    if (written <= 0)
+      break;
+    file_size_ += written;
+
+    while (count > 0 && static_cast<size_t>(written) >= pending->iov_len) {
+      written -= pending->iov_len;
+      pending++;
+      count--;
+    }
+    if (count > 0) {
+      pending->iov_base = static_cast<char*>(pending->iov_base) + written;
+      pending->iov_len -= written;
+    }
+  }
+#endif
+
+  buffer_used_ = 0;
+  if (flush_handler_)
+    flush_handler_(file_size_);
+}
+
+void LogFile::close()
+{
+  flush();
+
+  if (fd_ >= 0) {
+#ifdef __linux__
+    // release the blocks preallocated past the end of the file
+    if (preallocate_ > 0)
+      (void)ftruncate(fd_, static_cast<off_t>(file_size_));
+#endif
+#ifdef _WIN32
+    _close(fd_);
+#else
+    ::close(fd_);
+#endif
+  }
+
+  fd_          = -1;
+  hour_        = -1;
+  buffer_used_ = 0;
+
+  if (close_handler_ && path_.empty() == false)
+    close_handler_(path_);
+  path_.clear();
+}
+
+bool LogFile::isRotationTime(const struct tm& tm) const
+{
+  return (tm.tm_hour != hour_ || tm.tm_mday != day_ ||
+          tm.tm_mon + 1 != month_ || tm.tm_year + 1900 != year_);
+}
+
+void LogFile::open(const struct tm& tm, bool next_index)
+{
+  close();
+
+  year_  = tm.tm_year + 1900;
+  month_ = tm.tm_mon + 1;
+  day_   = tm.tm_mday;
+  hour_  = tm.tm_hour;
+
+  // Log saving path (directory is checked only on rotation)
+  char file_dir[260];
+  snprintf(file_dir, sizeof(file_dir), "%s/%04d_%02d_%02d", directory_.c_str(),
+           year_, month_, day_);
+
+  char file_time[14];
+  snprintf(file_time, sizeof(file_time), "%04d_%02d_%02d-%02d", year_, month_,
+           day_, hour_);
+
+#ifdef _WIN32
+  bool created = (_mkdir(file_dir) == 0);
+#else
+  bool created = (mkdir(file_dir, 0777) == 0);
+#endif
+
+  // file index : looked up once per hour & directory, tracked in memory after
+  // that (a directory switched back to continues its current file)
+  auto& position = positions_[directory_];
+  if (created || position.hour != hour_ || position.day != day_ ||
+      position.month != month_ || position.year != year_) {
+    position       = { year_, month_, day_, hour_, 0 };
+    position.index = lastIndex(file_dir, file_time);
+  }
+  else if (next_index) {
+    position.index++;
+  }
+
+  char filepath[280];
+  snprintf(filepath, sizeof(filepath), "%s/%s-%02d.%s", file_dir, file_time,
+           position.index + 1, extension_.c_str());
+
+#ifdef _WIN32
+  fd_ = _open(filepath, _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY,
+              _S_IREAD | _S_IWRITE);
+#else
+  fd_ = ::open(filepath, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0666);
+#endif
+
+  file_size_ = 0;
+  if (fd_ >= 0) {
+    path_ = filepath;
+    sequence_++;
+#ifdef _WIN32
+    file_size_ = static_cast<size_t>(_lseek(fd_, 0, SEEK_END));
+#else
+    struct stat st;
+    if (fstat(fd_, &st) == 0)
+      file_size_ = static_cast<size_t>(st.st_size);
+#endif
+
+#ifdef __linux__
+    // reserve blocks ahead (file size is kept : readers see written data only)
+    if (preallocate_ > file_size_)
+      fallocate(fd_, FALLOC_FL_KEEP_SIZE, file_size_,
+                preallocate_ - file_size_);
+#endif
+  }
+}
+
+void LogFile::makeDirectory(const std::string& path)
+{
+  std::string temp_path;
+  std::size_t pos = 0;
+  while ((pos = path.find_first_of("/", pos + 1)) != std::string::npos) {
+    temp_path = path.substr(0, pos);
+#ifdef _WIN32
+    _mkdir(temp_path.c_str());
+#else
+    mkdir(temp_path.c_str(), 0777);
+#endif
+  }
+#ifdef _WIN32
+  _mkdir(path.c_str());
+#else
+  mkdir(path.c_str(), 0777);
+#endif
+}
+
+int LogFile::lastIndex(const char* file_dir, const char* file_time) const
+{
+  int last = 0;
+#ifdef _WIN32
+  WIN32_FIND_DATAA file_data;
+  HANDLE           handle;
+
+  std::string path = std::string(file_dir) + "/*";
+  handle           = FindFirstFile(path.c_str(), &file_data);
+  if (handle != INVALID_HANDLE_VALUE) {
+    do {
+      if (!(file_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+        int index = fileIndex(file_data.cFileName, file_time);
+        if (index > last)
+          last = index;
+      }
+    } while (FindNextFile(handle, &file_data));
+    FindClose(handle);
+  }
+#else
+  DIR* dirp = opendir(file_dir);
+  if (dirp == nullptr)
+    return 0;
+
+  struct dirent* entry;
+  while ((entry = readdir(dirp)) != NULL) {
+    if (entry->d_type == DT_REG) {
+      int index = fileIndex(entry->d_name, file_time);
+      if (index > last)
+        last = index;
+    }
+  }
+  closedir(dirp);
+#endif
+  return last;
+}
+
+int LogFile::fileIndex(const char* name, const char* file_time) const
+{
+  // {file_time}-NN.{extension} or its archive ({extension}.gz), sidecars
+  // (.idx) & temporary files (.gz.tmp) are not counted
+  size_t length = strlen(file_time);
+  if (strncmp(name, file_time, length) != 0)
+    return 0;
+
+  int index    = 0;
+  int consumed = 0;
+  if (sscanf(name + length, "-%d%n", &index, &consumed) != 1 || index <= 0)
+    return 0;
+
+  const char* suffix = name + length + consumed;
+  if (*suffix++ != '.' ||
+      strncmp(suffix, extension_.c_str(), extension_.size()) != 0)
+    return 0;
+
+  suffix += extension_.size();
+  return (*suffix == '\0' || strcmp(suffix, ".gz") == 0) ? index : 0;
+}
+
+}  // namespace rs
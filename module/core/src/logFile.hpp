@@ -0,0 +1,112 @@
+#ifndef __ROWEN_SDK_CORE_LOGFILE_HPP__
+#define __ROWEN_SDK_CORE_LOGFILE_HPP__
+
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace rs {
+
+// Hourly log file with persistent handle and write buffer
+// ({directory}/YYYY_MM_DD/YYYY_MM_DD-HH-NN.{extension})
+class LogFile {
+ public:
+  explicit LogFile(const char* extension = "txt", size_t buffer_size = 65536);
+  ~LogFile();
+
+  LogFile(const LogFile&)            = delete;
+  LogFile& operator=(const LogFile&) = delete;
+
+  // change base directory (current file is closed)
+  void setDirectory(const std::string& directory);
+
+  // rotate when the file exceeds the limit (0 : unlimited)
+  void setSizeLimit(size_t bytes) { size_limit_ = bytes; }
+
+  // preallocate disk blocks of a new file (Linux fallocate, 0 : disabled)
+  void setPreallocate(size_t bytes) { preallocate_ = bytes; }
+
+  // called with the path of every closed file (rotation included)
+  void setCloseHandler(std::function<void(const std::string&)> handler)
+  {
+    close_handler_ = std::move(handler);
+  }
+
+  // called after buffered data is written (with the file size)
+  void setFlushHandler(std::function<void(size_t)> handler)
+  {
+    flush_handler_ = std::move(handler);
+  }
+
+  // open or rotate the file for the upcoming write (false : not opened)
+  bool prepare(const struct tm& tm, size_t length);
+
+  // buffered write (file is rotated on day/hour change or size limit)
+  void write(const struct tm& tm, const char* data, size_t length);
+
+  // write buffered data to the file
+  void flush();
+
+  // flush and close current file
+  void close();
+
+  // file size including buffered data (offset of the next write)
+  size_t size() const { return file_size_ + buffer_used_; }
+
+  // current file path (empty if not opened)
+  const std::string& path() const { return path_; }
+
+  // increased whenever a new file is opened
+  uint32_t sequence() const { return sequence_; }
+
+  // create directory (recursive)
+  static void makeDirectory(const std::string& path);
+
+ private:
+  void flush(const char* data, size_t length);
+  bool isRotationTime(const struct tm& tm) const;
+  void open(const struct tm& tm, bool next_index);
+  int  lastIndex(const char* directory, const char* file_time) const;
+  int  fileIndex(const char* name, const char* file_time) const;
+
+ private:
+  // hour & file index of a directory (kept while switching directories)
+  struct Position {
+    int year  = -1;
+    int month = -1;
+    int day   = -1;
+    int hour  = -1;
+    int index = 0;
+  };
+
+  std::string directory_;
+  std::string extension_;
+  std::string path_;
+
+  int      fd_          = -1;
+  uint32_t sequence_    = 0;
+  int      year_        = -1;
+  int      month_       = -1;
+  int      day_         = -1;
+  int      hour_        = -1;
+  int      flush_sec_   = -1;
+  size_t   file_size_   = 0;
+  size_t   size_limit_  = 0;
+  size_t   preallocate_ = 0;
+
+  std::unique_ptr<char[]> buffer_;
+  size_t                  buffer_size_;
+  size_t                  buffer_used_ = 0;
+
+  std::unordered_map<std::string, Position> positions_;
+
+  std::function<void(const std::string&)> close_handler_;
+  std::function<void(size_t)>             flush_handler_;
+};
+
+}  // namespace rs
+
+#endif  //__ROWEN_SDK_CORE_LOGFILE_HPP__
@@ -0,0 +1,73 @@
+#include "logFlusher.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace rs {
+
+// flush callbacks by owner & their timer
+struct FlusherRegistry {
+  std::mutex                                    mutex;
+  std::map<const void*, std::function<void()>> flushes;
+  std::once_flag                                started;
+  std::thread                                   timer;
+  std::condition_variable                       convar;
+  bool                                          stop = false;
+
+  ~FlusherRegistry()
+  {
+    {
+      std::unique_lock<std::mutex> ulock(mutex);
+      stop = true;
+    }
+    convar.notify_all();
+    if (timer.joinable())
+      timer.join();
+  }
+
+  // flushes run with the mutex held : remove waits for them
+  void run()
+  {
+    std::unique_lock<std::mutex> ulock(mutex);
+    while (stop == false) {
+      convar.wait_for(ulock, std::chrono::seconds(1));
+      for (auto& entry : flushes)
+        entry.second();
+    }
+  }
+};
+
+static FlusherRegistry& flusherRegistry()
+{
+  static FlusherRegistry registry;
+  return registry;
+}
+
+void LogFlusher::add(const void* owner, std::function<void()> flush)
+{
+  auto&                        registry = flusherRegistry();
+  std::unique_lock<std::mutex> ulock(registry.mutex);
+  registry.flushes[owner] = std::move(flush);
+}
+
+void LogFlusher::remove(const void* owner)
+{
+  auto&                        registry = flusherRegistry();
+  std::unique_lock<std::mutex> ulock(registry.mutex);
+  registry.flushes.erase(owner);
+}
+
+void LogFlusher::start()
+{
+  // (call_once : never waits on the registry mutex held by a flush)
+  auto& registry = flusherRegistry();
+  std::call_once(registry.started, [&registry] {
+    registry.timer = std::thread([&registry] { registry.run(); });
+  });
+}
+
+}  // namespace rs
@@ -0,0 +1,25 @@
+#ifndef __ROWEN_SDK_CORE_LOGFLUSHER_HPP__
+#define __ROWEN_SDK_CORE_LOGFLUSHER_HPP__
+
+#include <functional>
+
+namespace rs {
+
+// Once per second flush of buffered outputs (console, text & binary files),
+// so the tail of a burst is written even if no record follows
+class LogFlusher {
+ public:
+  // flush is called from the timer thread until remove (key : owner)
+  static void add(const void* owner, std::function<void()> flush);
+
+  // returns after a running flush of the owner (never call with a lock
+  // taken by its flush)
+  static void remove(const void* owner);
+
+  // start the timer thread (on the first buffered write)
+  static void start();
+};
+
+}  // namespace rs
+
+#endif  //__ROWEN_SDK_CORE_LOGFLUSHER_HPP__
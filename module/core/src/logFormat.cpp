@@ -0,0 +1,229 @@
+#include "logFormat.hpp"
+
+#include <cmath>
+#include <cstdio>
+
+namespace rs {
+
+// "00" ~ "99"
+static const char DIGITS[] =
+    "00010203040506070809101112131415161718192021222324"
+    "25262728293031323334353637383940414243444546474849"
+    "50515253545556575859606162636465666768697071727374"
+    "75767778798081828384858687888990919293949596979899";
+
+void FormatBuffer::printf(const char* format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  vprintf(format, args);
+  va_end(args);
+}
+
+void FormatBuffer::vprintf(const char* format, va_list args)
+{
+  va_list args_retry;
+  va_copy(args_retry, args);
+
+  auto length = vsnprintf(data_ + size_, capacity_ - size_, format, args);
+  if (length > 0 && static_cast<size_t>(length) >= capacity_ - size_) {
+    reserve(size_ + length + 1);
+    vsnprintf(data_ + size_, capacity_ - size_, format, args_retry);
+  }
+  va_end(args_retry);
+
+  if (length > 0)
+    size_ += length;
+}
+
+void FormatBuffer::grow(size_t capacity)
+{
+  capacity_ = capacity + FIXED_SIZE;
+  auto extend = std::make_unique<char[]>(capacity_);
+  memcpy(extend.get(), data_, size_);
+  extend_ = std::move(extend);
+  data_   = extend_.get();
+}
+
+void FormatBuffer::appendInteger(uint64_t value, bool negative)
+{
+  // written backward, two digits at a time
+  char  digits[24];
+  char* end   = digits + sizeof(digits);
+  char* begin = end;
+  while (value >= 100) {
+    auto index = (value % 100) * 2;
+    value /= 100;
+    *--begin = DIGITS[index + 1];
+    *--begin = DIGITS[index];
+  }
+  if (value >= 10) {
+    *--begin = DIGITS[value * 2 + 1];
+    *--begin = DIGITS[value * 2];
+  }
+  else {
+    *--begin = static_cast<char>('0' + value);
+  }
+  if (negative)
+    *--begin = '-';
+
+  append(begin, end - begin);
+}
+
+void FormatBuffer::appendFloat(double value)
+{
+  if (std::isnan(value)) {
+    append("nan", 3);
+    return;
+  }
+  if (std::signbit(value)) {
+    append('-');
+    value = -value;
+  }
+  if (std::isinf(value)) {
+    append("inf", 3);
+    return;
+  }
+
+  // scientific notation out of the fixed range
+  int exponent = 0;
+  if (value != 0 && (value < 1e-4 || value >= 1e15)) {
+    exponent = static_cast<int>(std::floor(std::log10(value)));
+    value /= std::pow(10.0, exponent);
+    if (value >= 10) {
+      value /= 10;
+      exponent++;
+    }
+  }
+
+  // integer part & 6 fractional digits (trailing zeros removed)
+  auto integer  = static_cast<uint64_t>(value);
+  auto fraction = static_cast<uint64_t>(
+      std::llround((value - static_cast<double>(integer)) * 1e6));
+  if (fraction >= 1000000) {
+    integer++;
+    fraction -= 1000000;
+  }
+  if (exponent != 0 && integer >= 10) {  // 9.9999999e+N -> 1e+(N+1)
+    integer = 1;
+    exponent++;
+  }
+  appendInteger(integer, false);
+
+  if (fraction > 0) {
+    char digits[7] = { '.' };
+    int  length    = 7;
+    for (int i = 6; i > 0; --i, fraction /= 10)
+      digits[i] = static_cast<char>('0' + fraction % 10);
+    while (digits[length - 1] == '0')
+      length--;
+    append(digits, length);
+  }
+
+  if (exponent != 0) {
+    append(exponent < 0 ? "e-" : "e+", 2);
+    auto magnitude = static_cast<uint64_t>(exponent < 0 ? -exponent : exponent);
+    if (magnitude < 10)
+      append('0');
+    appendInteger(magnitude, false);
+  }
+}
+
+void FormatBuffer::appendPointer(const void* pointer)
+{
+  static const char HEX[] = "0123456789abcdef";
+
+  char  digits[2 + sizeof(uintptr_t) * 2];
+  char* end   = digits + sizeof(digits);
+  char* begin = end;
+  auto  value = reinterpret_cast<uintptr_t>(pointer);
+  do {
+    *--begin = HEX[value & 0xF];
+    value >>= 4;
+  } while (value != 0);
+  *--begin = 'x';
+  *--begin = '0';
+
+  append(begin, end - begin);
+}
+
+namespace formatter {
+
+void appendJsonString(FormatBuffer& buffer, std::string_view text)
+{
+  static const char HEX[] = "0123456789abcdef";
+
+  buffer.append('"');
+  size_t begin = 0;
+  for (size_t i = 0; i < text.size(); ++i) {
+    auto c = static_cast<unsigned char>(text[i]);
+    if (c >= 0x20 && c != '"' && c != '\\')
+      continue;
+
+    buffer.append(text.data() + begin, i - begin);
+    begin = i + 1;
+    switch (c) {
+      case '"': buffer.append("\\\"", 2); break;
+      case '\\': buffer.append("\\\\", 2); break;
+      case '\n': buffer.append("\\n", 2); break;
+      case '\r': buffer.append("\\r", 2); break;
+      case '\t': buffer.append("\\t", 2); break;
+      default: {
+        char escape[6] = { '\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0xF] };
+        buffer.append(escape, sizeof(escape));
+      }
+    }
+  }
+  buffer.append(text.data() + begin, text.size() - begin);
+  buffer.append('"');
+}
+
+void appendLogfmtValue(FormatBuffer& buffer, std::string_view text)
+{
+  bool quote = text.empty();
+  for (auto c : text) {
+    if (c == ' ' || c == '=' || c == '"' ||
+        static_cast<unsigned char>(c) < 0x20)
+      quote = true;
+  }
+
+  if (quote)
+    appendJsonString(buffer, text);  // same escape rules
+  else
+    buffer.append(text.data(), text.size());
+}
+
+void appendJsonFields(FormatBuffer& buffer, const char* fields, size_t length)
+{
+  const char* end = fields + length;
+  Field       field;
+  while (readField(fields, end, field)) {
+    buffer.append(',');
+    appendJsonString(buffer, field.key);
+    buffer.append(':');
+
+    // nan & inf are not JSON numbers (no 'n' or 'i' in other numbers/bool)
+    bool finite = field.number &&
+                  field.value.find_first_of("ni") == std::string_view::npos;
+    if (finite)
+      buffer.append(field.value.data(), field.value.size());
+    else
+      appendJsonString(buffer, field.value);
+  }
+}
+
+void appendLogfmtFields(FormatBuffer& buffer, const char* fields,
+                        size_t length)
+{
+  const char* end = fields + length;
+  Field       field;
+  while (readField(fields, end, field)) {
+    buffer.append(' ');
+    buffer.append(field.key.data(), field.key.size());
+    buffer.append('=');
+    appendLogfmtValue(buffer, field.value);
+  }
+}
+
+}  // namespace formatter
+}  // namespace rs
@@ -0,0 +1,111 @@
+#include "logIndex.hpp"
+
+namespace rs {
+
+LogIndex::~LogIndex()
+{
+  close();
+}
+
+void LogIndex::setInterval(uint32_t records)
+{
+  if (records == 0)
+    close();
+  interval_ = records;
+}
+
+void LogIndex::open(const std::string& log_path)
+{
+  close();
+  if (interval_ == 0)
+    return;
+
+  file_ = fopen((log_path + ".idx").c_str(), "ab");
+  if (file_ == nullptr)
+    return;
+
+  // new index file (an existing one is continued)
+  fseek(file_, 0, SEEK_END);
+  if (ftell(file_) == 0) {
+    Header header = { MAGIC, VERSION, interval_, 0 };
+    fwrite(&header, sizeof(header), 1, file_);
+    fflush(file_);
+  }
+}
+
+void LogIndex::close()
+{
+  if (file_ == nullptr)
+    return;
+
+  // (blocks of unflushed data are dropped with it)
+  fclose(file_);
+  file_    = nullptr;
+  current_ = {};
+  pending_.clear();
+}
+
+void LogIndex::add(uint64_t offset, int64_t time_ms, int level)
+{
+  if (file_ == nullptr)
+    return;
+
+  if (current_.count >= interval_) {
+    current_.length = offset - current_.offset;
+    pending_.push_back(current_);
+    current_.count = 0;
+  }
+
+  if (current_.count == 0) {
+    current_.offset   = offset;
+    current_.first_ms = time_ms;
+    current_.last_ms  = time_ms;
+    current_.levels   = 0;
+  }
+  else if (time_ms > current_.last_ms) {
+    current_.last_ms = time_ms;
+  }
+  current_.levels |= 1u << level;
+  current_.count++;
+}
+
+void LogIndex::commit(uint64_t offset)
+{
+  if (file_ == nullptr)
+    return;
+
+  if (current_.count > 0) {
+    current_.length = offset - current_.offset;
+    pending_.push_back(current_);
+    current_.count = 0;
+  }
+  if (pending_.empty())
+    return;
+
+  fwrite(pending_.data(), sizeof(Block), pending_.size(), file_);
+  fflush(file_);
+  pending_.clear();
+}
+
+int64_t LogIndex::timeKey(int year, int month, int day, int hour, int minute,
+                          int second, int millisecond)
+{
+  // days from the civil date (proleptic Gregorian calendar)
+  year -= (month <= 2);
+  const int64_t era  = (year >= 0 ? year : year - 399) / 400;
+  const int64_t yoe  = year - era * 400;
+  const int64_t doy  = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  const int64_t doe  = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  const int64_t days = era * 146097 + doe - 719468;
+
+  return ((days * 24 + hour) * 60 + minute) * 60000 + second * 1000 +
+         millisecond;
+}
+
+int64_t LogIndex::timeKey(const struct tm& tm, int millisecond)
+{
+  return timeKey(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour,
+                 tm.tm_min, tm.tm_sec, millisecond);
+}
+
+}  // namespace rs
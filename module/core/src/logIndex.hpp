@@ -0,0 +1,74 @@
+#ifndef __ROWEN_SDK_CORE_LOGINDEX_HPP__
+#define __ROWEN_SDK_CORE_LOGINDEX_HPP__
+
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace rs {
+
+// Sidecar index of a log file ({file}.idx) : byte range, time range & level
+// bitmap of every block of records (a block ends every `interval` records
+// and on each flush of the log file, so the index covers all flushed data)
+//   [Header][Block][Block] ...  (appended, native byte order)
+class LogIndex {
+ public:
+  static constexpr uint32_t MAGIC   = 0x58495352;  // "RSIX"
+  static constexpr uint32_t VERSION = 1;
+
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t interval;
+    uint32_t reserved;
+  };
+
+  struct Block {
+    uint64_t offset;    // first byte in the log file
+    uint64_t length;    // bytes of the block
+    int64_t  first_ms;  // time of the first record (timeKey)
+    int64_t  last_ms;   // latest time of the records
+    uint32_t levels;    // 1 << Logger::Level of the records
+    uint32_t count;     // records
+  };
+
+ public:
+  LogIndex() = default;
+  ~LogIndex();
+
+  LogIndex(const LogIndex&)            = delete;
+  LogIndex& operator=(const LogIndex&) = delete;
+
+  // records per block (0 : disabled, the current index is closed)
+  void     setInterval(uint32_t records);
+  uint32_t interval() const { return interval_; }
+
+  // start the index of a log file (appended if it exists)
+  void open(const std::string& log_path);
+  void close();
+  bool isOpen() const { return file_ != nullptr; }
+
+  // record written at `offset` of the log file
+  void add(uint64_t offset, int64_t time_ms, int level);
+
+  // log file is written up to `offset` : end the current block and append
+  // the finished blocks to the index file
+  void commit(uint64_t offset);
+
+  // local wall-clock milliseconds since 1970-01-01 (no time zone lookup)
+  static int64_t timeKey(int year, int month, int day, int hour, int minute,
+                         int second, int millisecond);
+  static int64_t timeKey(const struct tm& tm, int millisecond);
+
+ private:
+  FILE*              file_     = nullptr;
+  uint32_t           interval_ = 0;
+  Block              current_  = {};
+  std::vector<Block> pending_;
+};
+
+}  // namespace rs
+
+#endif  //__ROWEN_SDK_CORE_LOGINDEX_HPP__
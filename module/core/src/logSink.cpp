@@ -0,0 +1,772 @@
+#include "logSink.hpp"
+
+#ifdef _WIN32
+  #include <io.h>
+#else
+  #include <dirent.h>
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/socket.h>
+  #include <sys/stat.h>
+  #include <sys/un.h>
+  #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <thread>
+
+namespace rs {
+
+////////////////////////////////////////////////////////////////////////////////
+// LogSink
+void LogSink::setLevel(Logger::Level level)
+{
+  uint32_t mask = 0;
+  for (int i = static_cast<int>(Logger::Level::FATAL);
+       i <= static_cast<int>(level) &&
+       i <= static_cast<int>(Logger::Level::TRACE);
+       ++i) {
+    mask |= 1u << i;
+  }
+  levels_.store(mask, std::memory_order_relaxed);
+  Logger::refreshLevels();
+}
+
+void LogSink::setLevelEnabled(Logger::Level level, bool enable)
+{
+  if (enable)
+    levels_.fetch_or(1u << static_cast<int>(level));
+  else
+    levels_.fetch_and(~(1u << static_cast<int>(level)));
+  Logger::refreshLevels();
+}
+
+// per-thread buffer of JSON & logfmt output
+thread_local FormatBuffer g_render_buffer;
+
+static const char* levelName(Logger::Level level)
+{
+  static const char* names[] = { "off",  "fatal", "error", "warn",
+                                 "info", "debug", "trace", "raw" };
+  return names[static_cast<int>(level) & 7];
+}
+
+// "YYYY-MM-DDTHH:MM:SS.mmm"
+static void appendTime(FormatBuffer& buffer, const LogRecord& record)
+{
+  const auto append = [&buffer](int value, int digits, char separator) {
+    char text[5];
+    for (int i = digits - 1; i >= 0; --i, value /= 10)
+      text[i] = static_cast<char>('0' + value % 10);
+    text[digits] = separator;
+    buffer.append(text, separator ? digits + 1 : digits);
+  };
+
+  const struct tm& tm = *record.tm;
+  append(tm.tm_year + 1900, 4, '-');
+  append(tm.tm_mon + 1, 2, '-');
+  append(tm.tm_mday, 2, 'T');
+  append(tm.tm_hour, 2, ':');
+  append(tm.tm_min, 2, ':');
+  append(tm.tm_sec, 2, '.');
+  append(record.millisecond, 3, '\0');
+}
+
+static void renderJson(FormatBuffer& buffer, const LogRecord& record)
+{
+  std::string_view message(record.content + record.header_length,
+                           record.message_length - record.header_length);
+
+  buffer.append("{\"time\":\"", 9);
+  appendTime(buffer, record);
+  buffer.append("\",\"level\":\"", 11);
+  auto level = levelName(record.level);
+  buffer.append(level, strlen(level));
+  buffer.append("\",\"msg\":", 8);
+  formatter::appendJsonString(buffer, message);
+  if (record.file) {
+    buffer.append(",\"file\":", 8);
+    formatter::appendJsonString(buffer, record.file);
+    buffer.append(",\"line\":", 8);
+    buffer.appendInteger(static_cast<uint64_t>(record.line), false);
+  }
+  formatter::appendJsonFields(buffer, record.fields, record.fields_length);
+  buffer.append('}');
+}
+
+static void renderLogfmt(FormatBuffer& buffer, const LogRecord& record)
+{
+  std::string_view message(record.content + record.header_length,
+                           record.message_length - record.header_length);
+
+  buffer.append("time=", 5);
+  appendTime(buffer, record);
+  buffer.append(" level=", 7);
+  auto level = levelName(record.level);
+  buffer.append(level, strlen(level));
+  buffer.append(" msg=", 5);
+  formatter::appendLogfmtValue(buffer, message);
+  if (record.file) {
+    buffer.append(" file=", 6);
+    formatter::appendLogfmtValue(buffer, record.file);
+    buffer.append(" line=", 6);
+    buffer.appendInteger(static_cast<uint64_t>(record.line), false);
+  }
+  formatter::appendLogfmtFields(buffer, record.fields, record.fields_length);
+}
+
+LogSink::Text LogSink::text(const LogRecord& record) const
+{
+  const auto format = this->format();
+  switch (format) {
+    case Format::JSON:
+    case Format::LOGFMT: {
+      FormatBuffer& buffer = g_render_buffer;
+      buffer.clear();
+      if (format == Format::JSON)
+        renderJson(buffer, record);
+      else
+        renderLogfmt(buffer, record);
+      return { buffer.data(), buffer.size(), true };
+    }
+    case Format::SHORT:
+      return { record.content, record.body_length, true };
+    case Format::MESSAGE:
+      return { record.content + record.header_length,
+               record.body_length - record.header_length, true };
+    case Format::FULL:
+    default:
+      return { record.content, record.length, false };
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ConsoleSink
+// ANSI escape of each level (index : Logger::Level)
+struct ColorCode {
+  const char* data;
+  size_t      length;
+};
+
+static const ColorCode LEVEL_COLORS[] = {
+  { "", 0 },               // OFF
+  { "\x1b[1;31m", 7 },     // FATAL : bold red
+  { "\x1b[31m", 5 },       // ERROR : red
+  { "\x1b[33m", 5 },       // WARN  : yellow
+  { "", 0 },               // INFO  : default
+  { "\x1b[36m", 5 },       // DEBUG : cyan
+  { "\x1b[90m", 5 },       // TRACE : gray
+  { "", 0 },               // RAW
+};
+static const ColorCode COLOR_RESET = { "\x1b[0m", 4 };
+
+// write all (continued after a partial write or signal), async-signal-safe
+static void writeAll(int fd, const char* data, size_t length)
+{
+#ifdef _WIN32
+  _write(fd, data, static_cast<unsigned int>(length));
+#else
+  while (length > 0) {
+    auto written = ::write(fd, data, length);
+    if (written < 0 && errno == EINTR)
+      continue;
+    if (written <= 0)
+      break;
+    data += written;
+    length -= written;
+  }
+#endif
+}
+
+// buffered output of a file descriptor (shared by its sinks)
+struct ConsoleSink::Output {
+  Output(int fd, size_t size)
+      : fd(fd), buffer(std::make_unique<char[]>(size)), size(size)
+  {
+    LogFlusher::add(this, [this] {
+      std::unique_lock<std::mutex> ulock(mutex);
+      flush();
+    });
+  }
+  ~Output()
+  {
+    LogFlusher::remove(this);
+    flush();
+  }
+
+  // (with mutex)
+  void append(const char* data, size_t length)
+  {
+    if (used + length > size) {
+      flush();
+      if (length > size) {
+        writeAll(fd, data, length);  // oversized : written directly
+        return;
+      }
+    }
+    memcpy(buffer.get() + used, data, length);
+    used += length;
+  }
+
+  // (with mutex)
+  void flush()
+  {
+    writeAll(fd, buffer.get(), used);
+    used = 0;
+  }
+
+  // output of the file descriptor (created by the first sink)
+  static std::shared_ptr<Output> open(int fd, size_t size);
+
+  int                     fd;
+  std::mutex              mutex;
+  std::unique_ptr<char[]> buffer;
+  size_t                  size;
+  size_t                  used = 0;
+};
+
+std::shared_ptr<ConsoleSink::Output> ConsoleSink::Output::open(int fd,
+                                                               size_t size)
+{
+  // outputs by file descriptor
+  static std::mutex                           mutex;
+  static std::map<int, std::weak_ptr<Output>> outputs;
+  std::unique_lock<std::mutex>                ulock(mutex);
+
+  auto output = outputs[fd].lock();
+  if (output == nullptr) {
+    output      = std::make_shared<Output>(fd, size);
+    outputs[fd] = output;
+  }
+  return output;
+}
+
+ConsoleSink::ConsoleSink(int fd, size_t buffer_size)
+    : LogSink(Format::SHORT),
+      output_(Output::open(fd, buffer_size)),
+#ifdef _WIN32
+      terminal_(_isatty(fd) != 0)
+#else
+      terminal_(isatty(fd) != 0)
+#endif
+{
+  line_buffered_.store(terminal_);
+}
+
+ConsoleSink::~ConsoleSink()
+{
+  flush();
+}
+
+void ConsoleSink::write(const LogRecord& record)
+{
+  auto text = this->text(record);
+
+  const ColorCode* color = nullptr;
+  if (terminal_ && color_.load(std::memory_order_relaxed)) {
+    color = &LEVEL_COLORS[static_cast<int>(record.level) & 7];
+    if (color->length == 0)
+      color = nullptr;
+  }
+
+  bool buffered = false;
+  {
+    std::unique_lock<std::mutex> ulock(output_->mutex);
+    if (color) {
+      // color stops before the line feed
+      size_t length = text.length;
+      if (text.newline == false && length > 0 &&
+          text.data[length - 1] == '\n')
+        length--;
+      output_->append(color->data, color->length);
+      output_->append(text.data, length);
+      output_->append(COLOR_RESET.data, COLOR_RESET.length);
+      output_->append("\n", 1);
+    }
+    else {
+      output_->append(text.data, text.length);
+      if (text.newline)
+        output_->append("\n", 1);
+    }
+
+    if (line_buffered_.load(std::memory_order_relaxed) ||
+        record.level <= Logger::Level::ERROR)
+      output_->flush();
+    else
+      buffered = (output_->used > 0);
+  }
+
+  // (an idle process is flushed by the timer)
+  if (buffered)
+    LogFlusher::start();
+}
+
+void ConsoleSink::flush()
+{
+  std::unique_lock<std::mutex> ulock(output_->mutex);
+  output_->flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// FileSink
+FileSink::FileSink(const std::string& directory) : directory_(directory)
+{
+  file_.setFlushHandler([this](size_t size) { index_.commit(size); });
+  file_.setCloseHandler([this](const std::string& path) {
+    index_.close();
+    archiver_.push(path);
+  });
+
+  if (directory.empty() == false) {
+    LogFile::makeDirectory(directory);
+    file_.setDirectory(directory);
+  }
+
+  LogFlusher::add(this, [this] { flush(); });
+}
+
+FileSink::~FileSink()
+{
+  LogFlusher::remove(this);
+}
+
+void FileSink::setDirectory(const std::string& directory)
+{
+  std::unique_lock<std::mutex> ulock(mutex_);
+  file_.setDirectory(directory);
+  directory_ = directory;
+  archiver_.setRetention(directory_, retention_);
+}
+
+void FileSink::setSizeLimit(size_t bytes)
+{
+  std::unique_lock<std::mutex> ulock(mutex_);
+  file_.setSizeLimit(bytes);
+}
+
+void FileSink::setPreallocate(size_t bytes)
+{
+  std::unique_lock<std::mutex> ulock(mutex_);
+  file_.setPreallocate(bytes);
+}
+
+void FileSink::setCompression(bool enable)
+{
+  archiver_.setCompression(enable);
+}
+
+void FileSink::setRetention(uint64_t bytes)
+{
+  std::unique_lock<std::mutex> ulock(mutex_);
+  retention_ = bytes;
+  archiver_.setRetention(directory_, retention_);
+}
+
+void FileSink::setIndex(uint32_t records)
+{
+  std::unique_lock<std::mutex> ulock(mutex_);
+  index_.setInterval(records);
+  index_sequence_ = 0;  // (re)opened with the next record
+}
+
+void FileSink::write(const LogRecord& record)
+{
+  auto text = this->text(record);
+
+  // (an idle process is flushed by the timer)
+  LogFlusher::start();
+
+  std::unique_lock<std::mutex> ulock(mutex_);
+  if (index_.interval() > 0 &&
+      file_.prepare(*record.tm, text.length + (text.newline ? 1 : 0))) {
+    if (index_sequence_ != file_.sequence()) {
+      index_sequence_ = file_.sequence();
+      index_.open(file_.path());
+    }
+    index_.add(file_.size(),
+               LogIndex::timeKey(*record.tm, record.millisecond),
+               static_cast<int>(record.level));
+  }
+  file_.write(*record.tm, text.data, text.length);
+  if (text.newline)
+    file_.write(*record.tm, "\n", 1);
+
+  // do not keep errors in the buffer
+  if (record.level <= Logger::Level::ERROR)
+    file_.flush();
+}
+
+void FileSink::flush()
+{
+  std::unique_lock<std::mutex> ulock(mutex_);
+  file_.flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// RingSink
+RingSink::RingSink(size_t capacity, size_t record_size)
+    : LogSink(Format::FULL),
+      capacity_(capacity > 0 ? capacity : 1),
+      record_size_(record_size > 1 ? record_size : 2),
+      slots_(std::make_unique<Slot[]>(capacity_)),
+      data_(std::make_unique<char[]>(capacity_ * record_size_)),
+      scratch_(std::make_unique<char[]>(record_size_))
+{
+}
+
+void RingSink::write(const LogRecord& record)
+{
+  auto text = this->text(record);
+
+  // reserve slot (writers never wait for each other)
+  auto  position = position_.fetch_add(1, std::memory_order_relaxed);
+  auto& slot     = slots_[position % capacity_];
+  char* data     = data_.get() + (position % capacity_) * record_size_;
+
+  slot.sequence.store(position * 2 + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  size_t length = std::min(text.length, record_size_ - 1);
+  memcpy(data, text.data, length);
+  if (text.newline || length < text.length)
+    data[length++] = '\n';
+
+  slot.length.store(static_cast<uint32_t>(length), std::memory_order_relaxed);
+  slot.sequence.store(position * 2 + 2, std::memory_order_release);
+}
+
+std::vector<std::string> RingSink::snapshot() const
+{
+  std::vector<std::string> records;
+
+  auto end   = position_.load(std::memory_order_acquire);
+  auto begin = (end > capacity_) ? end - capacity_ : 0;
+  records.reserve(end - begin);
+
+  std::string text;
+  for (auto position = begin; position < end; ++position) {
+    const auto& slot = slots_[position % capacity_];
+    const char* data = data_.get() + (position % capacity_) * record_size_;
+
+    // skip slots being written or already overwritten
+    auto sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence != position * 2 + 2)
+      continue;
+
+    auto length = slot.length.load(std::memory_order_relaxed);
+    text.assign(data, std::min<size_t>(length, record_size_));
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) == sequence)
+      records.push_back(text);
+  }
+  return records;
+}
+
+void RingSink::dump(int fd) const
+{
+  if (dumping_.exchange(true, std::memory_order_acquire))
+    return;
+
+  auto end   = position_.load(std::memory_order_acquire);
+  auto begin = (end > capacity_) ? end - capacity_ : 0;
+
+  char* text = scratch_.get();
+  for (auto position = begin; position < end; ++position) {
+    const auto& slot = slots_[position % capacity_];
+    const char* data = data_.get() + (position % capacity_) * record_size_;
+
+    // skip slots being written or already overwritten
+    auto sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence != position * 2 + 2)
+      continue;
+
+    auto length = std::min<size_t>(slot.length.load(), record_size_);
+    memcpy(text, data, length);
+
+    // overwritten during the copy : torn, dropped
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+      continue;
+
+    writeAll(fd, text, length);
+  }
+  dumping_.store(false, std::memory_order_release);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// MappedFileSink
+struct MappedFileSink::Segment {
+  // reserved : used bytes (SEALED : no more reservation)
+  static constexpr size_t SEALED = ~(~size_t(0) >> 1);
+
+  int    fd   = -1;
+  char*  data = nullptr;
+  size_t size = 0;
+  int    hour = 0;  // YYYYMMDDHH
+
+  std::atomic<size_t> reserved  = { 0 };
+  std::atomic<size_t> committed = { 0 };
+};
+
+static int hourKey(const struct tm& tm)
+{
+  return (((tm.tm_year + 1900) * 100 + tm.tm_mon + 1) * 100 + tm.tm_mday) *
+             100 +
+         tm.tm_hour;
+}
+
+MappedFileSink::MappedFileSink(const std::string& directory,
+                               size_t             segment_size)
+    : LogSink(Format::FULL), directory_(directory), segment_size_(segment_size)
+{
+  LogFile::makeDirectory(directory_);
+}
+
+MappedFileSink::~MappedFileSink()
+{
+  std::unique_lock<std::mutex> ulock(mutex_);
+  close(current_.exchange(nullptr));
+}
+
+void MappedFileSink::write(const LogRecord& record)
+{
+  auto   text   = this->text(record);
+  size_t length = std::min(text.length, segment_size_ - 1);
+  size_t total  = length + (text.newline || length < text.length ? 1 : 0);
+  int    hour   = hourKey(*record.tm);
+
+  while (true) {
+    Segment* segment = current_.load(std::memory_order_acquire);
+    if (segment == nullptr || segment->hour < hour) {
+      if (roll(segment, *record.tm) == false)
+        return;
+      continue;
+    }
+
+    // reserve (fails if sealed or full)
+    size_t offset = segment->reserved.load(std::memory_order_relaxed);
+    bool   done   = false;
+    while ((offset & Segment::SEALED) == 0 && offset + total <= segment->size) {
+      if (segment->reserved.compare_exchange_weak(offset, offset + total,
+                                                  std::memory_order_acq_rel)) {
+        done = true;
+        break;
+      }
+    }
+    if (done == false) {
+      if (roll(segment, *record.tm) == false)
+        return;
+      continue;
+    }
+
+    memcpy(segment->data + offset, text.data, length);
+    if (total > length)
+      segment->data[offset + length] = '\n';
+    segment->committed.fetch_add(total, std::memory_order_release);
+    return;
+  }
+}
+
+void MappedFileSink::flush()
+{
+#ifndef _WIN32
+  std::unique_lock<std::mutex> ulock(mutex_);
+  auto                         segment = current_.load();
+  if (segment)
+    msync(segment->data, segment->size, MS_ASYNC);
+#endif
+}
+
+bool MappedFileSink::roll(Segment* full, const struct tm& tm)
+{
+#ifdef _WIN32
+  (void)full;
+  (void)tm;
+  return false;  // not supported
+#else
+  std::unique_lock<std::mutex> ulock(mutex_);
+  if (current_.load() != full)
+    return true;  // already rolled by another thread
+
+  // {directory}/YYYY_MM_DD/YYYY_MM_DD-HH-NN.seg
+  char file_dir[512];
+  snprintf(file_dir, sizeof(file_dir), "%s/%04d_%02d_%02d", directory_.c_str(),
+           tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+  mkdir(file_dir, 0777);
+
+  char file_time[14];
+  snprintf(file_time, sizeof(file_time), "%04d_%02d_%02d-%02d",
+           tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour);
+
+  // index : continue after existing segments of the hour
+  if (full == nullptr || full->hour != hourKey(tm)) {
+    index_ = 0;
+    if (DIR* dir = opendir(file_dir)) {
+      while (struct dirent* entry = readdir(dir)) {
+        if (strncmp(entry->d_name, file_time, strlen(file_time)) == 0 &&
+            strstr(entry->d_name, ".seg"))
+          index_++;
+      }
+      closedir(dir);
+    }
+  }
+
+  char path[600];
+  snprintf(path, sizeof(path), "%s/%s-%02d.seg", file_dir, file_time,
+           ++index_);
+
+  auto segment  = std::make_unique<Segment>();
+  segment->size = segment_size_;
+  segment->hour = hourKey(tm);
+  segment->fd   = ::open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+  if (segment->fd < 0)
+    return false;
+
+  // reserve blocks (no SIGBUS on a full disk while writing to the mapping)
+  int allocated = -1;
+  #ifdef __linux__
+  allocated = fallocate(segment->fd, 0, 0, segment->size);
+  #endif
+  if (allocated != 0 && ftruncate(segment->fd, segment->size) != 0) {
+    ::close(segment->fd);
+    return false;
+  }
+
+  void* data = mmap(nullptr, segment->size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                    segment->fd, 0);
+  if (data == MAP_FAILED) {
+    ::close(segment->fd);
+    return false;
+  }
+  segment->data = static_cast<char*>(data);
+
+  current_.store(segment.get(), std::memory_order_release);
+  segments_.push_back(std::move(segment));
+
+  close(full);
+  return true;
+#endif
+}
+
+void MappedFileSink::close(Segment* segment)
+{
+#ifndef _WIN32
+  if (segment == nullptr || segment->data == nullptr)
+    return;
+
+  // seal and wait for the writers of reserved ranges
+  size_t used = segment->reserved.fetch_or(Segment::SEALED) & ~Segment::SEALED;
+  while (segment->committed.load(std::memory_order_acquire) < used)
+    std::this_thread::yield();
+
+  munmap(segment->data, segment->size);
+  segment->data = nullptr;
+
+  // cut the unused tail
+  while (ftruncate(segment->fd, used) != 0 && errno == EINTR) {
+  }
+  ::close(segment->fd);
+  segment->fd = -1;
+#else
+  (void)segment;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SocketSink
+SocketSink::SocketSink(const std::string& path) : LogSink(Format::FULL)
+{
+  path_ = path;
+#ifndef _WIN32
+  fd_ = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+#endif
+}
+
+SocketSink::~SocketSink()
+{
+#ifndef _WIN32
+  if (fd_ >= 0)
+    close(fd_);
+#endif
+}
+
+void SocketSink::write(const LogRecord& record)
+{
+#ifndef _WIN32
+  if (fd_ < 0) {
+    dropped_++;
+    return;
+  }
+
+  auto text = this->text(record);
+
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, path_.c_str(), sizeof(address.sun_path) - 1);
+
+  struct iovec iov[2];
+  iov[0].iov_base = const_cast<char*>(text.data);
+  iov[0].iov_len  = text.length;
+  iov[1].iov_base = const_cast<char*>("\n");
+  iov[1].iov_len  = 1;
+
+  struct msghdr message;
+  memset(&message, 0, sizeof(message));
+  message.msg_name    = &address;
+  message.msg_namelen = sizeof(address);
+  message.msg_iov     = iov;
+  message.msg_iovlen  = text.newline ? 2 : 1;
+
+  // never block the logging thread
+  if (sendmsg(fd_, &message, MSG_DONTWAIT | MSG_NOSIGNAL) < 0)
+    dropped_++;
+#else
+  (void)record;
+  dropped_++;  // not supported
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SharedRingSink
+SharedRingSink::SharedRingSink(const std::string& name, size_t capacity,
+                               size_t record_size)
+    : LogSink(Format::FULL)
+{
+  ring_.open(name, capacity, record_size);
+}
+
+void SharedRingSink::write(const LogRecord& record)
+{
+  // the whole record is sent (text, fields, file & line), the collector
+  // renders its own format
+  SharedRing::Entry entry;
+  entry.level          = static_cast<uint8_t>(record.level);
+  entry.raw            = record.raw;
+  entry.millisecond    = static_cast<uint16_t>(record.millisecond);
+  entry.year           = static_cast<uint16_t>(record.tm->tm_year + 1900);
+  entry.month          = static_cast<uint8_t>(record.tm->tm_mon + 1);
+  entry.day            = static_cast<uint8_t>(record.tm->tm_mday);
+  entry.hour           = static_cast<uint8_t>(record.tm->tm_hour);
+  entry.minute         = static_cast<uint8_t>(record.tm->tm_min);
+  entry.second         = static_cast<uint8_t>(record.tm->tm_sec);
+  entry.reserved       = 0;
+  entry.header_length  = static_cast<uint32_t>(record.header_length);
+  entry.body_length    = static_cast<uint32_t>(record.body_length);
+  entry.message_length = static_cast<uint32_t>(record.message_length);
+  entry.length         = static_cast<uint32_t>(record.length);
+  entry.line           = record.line;
+  entry.fields_length  = static_cast<uint32_t>(record.fields_length);
+  entry.file_length =
+      static_cast<uint32_t>(record.file ? strlen(record.file) : 0);
+
+  if (ring_.push(entry, record.content, record.fields, record.file) == false)
+    dropped_++;
+}
+
+}  // namespace rs
@@ -0,0 +1,72 @@
+#include "logThrottle.hpp"
+
+#include <algorithm>
+
+namespace rs {
+
+std::atomic<LogThrottle::Mode> LogThrottle::mode_        = { Mode::NONE };
+std::atomic<int64_t>           LogThrottle::interval_ns_ = { 0 };
+std::atomic<int64_t>           LogThrottle::capacity_ns_ = { 0 };
+std::atomic<uint32_t>          LogThrottle::sampling_    = { 1 };
+std::atomic<int64_t>           LogThrottle::repeat_ns_   = { 0 };
+
+void LogThrottle::configure(Mode mode, uint32_t rate, uint32_t burst)
+{
+  if (rate == 0)
+    mode = Mode::NONE;
+
+  if (mode == Mode::TOKEN_BUCKET) {
+    auto interval = 1000000000LL / rate;
+    interval_ns_.store(interval, std::memory_order_relaxed);
+    capacity_ns_.store(interval * std::max<uint32_t>(burst, 1),
+                       std::memory_order_relaxed);
+  }
+  else if (mode == Mode::SAMPLING) {
+    sampling_.store(rate, std::memory_order_relaxed);
+  }
+  mode_.store(mode, std::memory_order_relaxed);
+}
+
+void LogThrottle::setRepeatInterval(uint32_t interval_ms)
+{
+  repeat_ns_.store(interval_ms * 1000000LL, std::memory_order_relaxed);
+}
+
+bool LogThrottle::acquireToken()
+{
+  const auto now      = this->now();
+  const auto interval = interval_ns_.load(std::memory_order_relaxed);
+  const auto capacity = capacity_ns_.load(std::memory_order_relaxed);
+
+  // each record moves the "full" time by one interval, the bucket is empty
+  // when the "full" time is more than its capacity ahead
+  auto full_at = full_at_ns_.load(std::memory_order_relaxed);
+  while (true) {
+    auto next = std::max(full_at, now) + interval;
+    if (next - now > capacity)
+      return false;
+    if (full_at_ns_.compare_exchange_weak(full_at, next,
+                                          std::memory_order_relaxed))
+      return true;
+  }
+}
+
+bool LogThrottle::unique(uint64_t hash, int64_t now_ns)
+{
+  const auto interval = repeat_ns_.load(std::memory_order_relaxed);
+  if (interval <= 0)
+    return true;
+
+  // repeated message : count only (until the interval is over)
+  if (last_hash_.load(std::memory_order_relaxed) == hash &&
+      now_ns < repeat_until_.load(std::memory_order_relaxed)) {
+    repeated_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  last_hash_.store(hash, std::memory_order_relaxed);
+  repeat_until_.store(now_ns + interval, std::memory_order_relaxed);
+  return true;
+}
+
+}  // namespace rs
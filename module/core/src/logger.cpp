@@ -3,442 +3,1496 @@
 #ifdef _WIN32
   #include <Windows.h>
   #include <direct.h>
+  #include <fcntl.h>
   #include <io.h>
-  #include <sys/timeb.h>
+  #include <process.h>
+  #include <sys/stat.h>
   #undef ERROR
 #else
-  #include <dirent.h>
+  #include <fcntl.h>
   #include <sys/stat.h>
-  #include <sys/timeb.h>
+  #include <unistd.h>
 #endif
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
 #include <cstdarg>
 #include <cstring>
+#include <fstream>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <thread>
+#include <unordered_set>
+
+#include "logFile.hpp"
+#include "logFlusher.hpp"
+#include "logSink.hpp"
+#include "mpscQueue.hpp"
 
 namespace rs {
 
-const uint32_t LOGGER_BUFFER_SIZE = 16384;
+// per-thread record buffer & structured fields of the record
+thread_local FormatBuffer g_log_buffer;
+thread_local FormatBuffer g_field_buffer;
+
+// per-thread timestamp : calendar fields and header text are rebuilt only
+// when the second changes, milliseconds are patched in per record
+struct Timestamp {
+  int64_t   second      = -1;
+  int       millisecond = 0;
+  struct tm tm          = {};
+  char      date_time[24];  // "[YYYY-MM-DD HH:MM:SS."
+  char      time[16];       // "[HH:MM:SS."
+
+  void update(int64_t epoch_ms)
+  {
+    millisecond = static_cast<int>(epoch_ms % 1000);
+    if (epoch_ms / 1000 == second)
+      return;
+
+    second   = epoch_ms / 1000;
+    time_t t = static_cast<time_t>(second);
+#ifdef _WIN32
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm);
+#endif
+    snprintf(date_time, sizeof(date_time), "[%04d-%02d-%02d %02d:%02d:%02d.",
+             tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour,
+             tm.tm_min, tm.tm_sec);
+    snprintf(time, sizeof(time), "[%02d:%02d:%02d.", tm.tm_hour, tm.tm_min,
+             tm.tm_sec);
+  }
+
+  // wall clock, whatever rs::Time clock is selected (records carry epoch ms)
+  void now()
+  {
+    using namespace std::chrono;
+    update(duration_cast<milliseconds>(system_clock::now().time_since_epoch())
+               .count());
+  }
+};
+
+thread_local Timestamp g_timestamp;
+
+// "%-7s " formatted level keyword
+static const char* levelKeyword(Logger::Level level)
+{
+  switch (level) {
+    case Logger::Level::FATAL:
+      return "[FATAL] ";
+    case Logger::Level::ERROR:
+      return "[ERROR] ";
+    case Logger::Level::WARN:
+      return "[WARN]  ";
+    case Logger::Level::INFO:
+      return "[INFO]  ";
+    case Logger::Level::DEBUG:
+      return "[DEBUG] ";
+    case Logger::Level::TRACE:
+      return "[TRACE] ";
+    default:
+      return "        ";
+  }
+}
 
-std::mutex g_mutex_loggerLock;
+// FNV-1a (repeated message detection)
+static uint64_t messageHash(const char* data, size_t length)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < length; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
 
 // static variables
-Logger::Level  Logger::option_logging_level_  = Logger::Level::INFO;
-Logger::Target Logger::option_logging_target_ = Logger::Target::CONSOLE_FILE;
-bool           Logger::option_enable_tarce_logging_ = true;
-bool           Logger::option_enable_header_date_   = false;
+std::atomic<bool> Logger::option_enable_binary_logging_ = { false };
+
+// default : FATAL ~ INFO (console & file), TRACE (file)
+std::atomic<uint32_t> Logger::enabled_levels_ = {
+  (1u << static_cast<int>(Level::FATAL)) |
+  (1u << static_cast<int>(Level::ERROR)) |
+  (1u << static_cast<int>(Level::WARN)) |
+  (1u << static_cast<int>(Level::INFO)) |
+  (1u << static_cast<int>(Level::TRACE))
+};
+
+// binary log file (logger_bin_*)
+std::mutex g_mutex_binaryLock;
+LogFile    g_binary_file("bin");
+
+// flushed once per second (destroyed before the file)
+struct BinaryFlush {
+  BinaryFlush()
+  {
+    LogFlusher::add(this, [] {
+      std::unique_lock<std::mutex> block(g_mutex_binaryLock);
+      g_binary_file.flush();
+    });
+  }
+  ~BinaryFlush() { LogFlusher::remove(this); }
+} g_binary_flush;
+
+// configuration snapshot : an immutable copy is swapped on change (RCU,
+// lock-free reading), replaced snapshots are freed once no reader is left
+// (Context::Snapshot)
+struct LogConfig {
+  Logger::Level  level       = Logger::Level::INFO;
+  Logger::Target target      = Logger::Target::CONSOLE_FILE;
+  bool           trace       = true;
+  bool           header_date = false;
+  std::string    directory;  // empty until the first record or setDirectory
+
+  // registered sinks
+  std::vector<std::string>              names;
+  std::vector<std::shared_ptr<LogSink>> sinks;
+};
+
+// queued log record (asynchronous mode)
+struct Logger::Record {
+  Logger::Level level          = Logger::Level::OFF;
+  bool          raw            = false;
+  struct tm     tm             = {};
+  int           millisecond    = 0;
+  int           line           = 0;
+  size_t        header_length  = 0;
+  size_t        body_length    = 0;
+  size_t        message_length = 0;
+  std::string   file;
+  std::string   content;  // capacity is kept while the slot is reused
+  std::string   fields;
+};
+
+// reloads a configuration file on modification (polling)
+struct ConfigWatcher {
+  std::mutex              mutex;
+  std::condition_variable convar;
+  std::thread             thread;
+  bool                    stop = false;
+
+  ~ConfigWatcher() { shutdown(); }
+
+  void shutdown()
+  {
+    {
+      std::unique_lock<std::mutex> ulock(mutex);
+      stop = true;
+    }
+    convar.notify_all();
+
+    if (thread.joinable())
+      thread.join();
+  }
+};
+
+// asynchronous writer state
+struct AsyncContext {
+  std::atomic_bool enabled  = { false };
+  std::atomic_bool running  = { false };
+  std::atomic_bool sleeping = { false };
+  bool             stop     = false;
+
+  std::unique_ptr<MPSCQueue<Logger::Record>> queue;
+  std::thread                                thread;
+
+  std::atomic<uint64_t> pushed    = { 0 };
+  std::atomic<uint64_t> written   = { 0 };
+  std::atomic<uint32_t> producers = { 0 };  // threads that may use the queue
+  std::atomic<uint32_t> blocked   = { 0 };  // producers waiting for space
+
+  std::mutex              control_mutex;
+  std::mutex              wait_mutex;
+  std::condition_variable convar;   // wake up writer
+  std::condition_variable flushed;  // writer drained the queue
+  std::condition_variable space;    // writer popped records (full queue)
+
+  ~AsyncContext()
+  {
+    enabled.store(false);
+    quiesce();
+    shutdown();
+  }
+
+  void notify() { convar.notify_one(); }
+
+  // (writer) wake up producers blocked on a full queue
+  void notifySpace()
+  {
+    if (blocked.load() == 0)
+      return;
+    std::unique_lock<std::mutex> ulock(wait_mutex);
+    space.notify_all();
+  }
+
+  // (producer) wait until the writer pops records, the timeout covers a
+  // wake-up lost between the full check and the wait
+  void waitSpace(std::chrono::steady_clock::time_point deadline)
+  {
+    std::unique_lock<std::mutex> ulock(wait_mutex);
+    blocked.fetch_add(1);
+    if (queue->size() >= queue->capacity() && stop == false) {
+      auto until = std::chrono::steady_clock::now() +
+                   std::chrono::milliseconds(10);
+      space.wait_until(ulock, std::min(until, deadline));
+    }
+    blocked.fetch_sub(1);
+  }
+
+  // wait for producers that saw `enabled` before it was cleared (the queue
+  // is not touched by anyone but the writer after this)
+  void quiesce()
+  {
+    while (producers.load() > 0)
+      std::this_thread::yield();
+  }
 
-char                                               Logger::directory_[260];
-std::unordered_map<std::string, Logger::Directory> Logger::directories_;
+  void shutdown()
+  {
+    {
+      std::unique_lock<std::mutex> ulock(wait_mutex);
+      stop = true;
+    }
+    convar.notify_all();
+
+    if (thread.joinable())
+      thread.join();
+  }
+};
+
+// state of a logger instance
+struct Logger::Instance::Context {
+  // directory creation (with mutex)
+  std::mutex                      mutex;
+  std::unordered_set<std::string> directories;
+  std::atomic_bool                directory_ready = { false };
+
+  // default sinks (shared : replaces the file, atomic_load/store)
+  std::shared_ptr<ConsoleSink>    console = std::make_shared<ConsoleSink>();
+  std::shared_ptr<FileSink>       file    = std::make_shared<FileSink>();
+  std::shared_ptr<SharedRingSink> shared;
+
+  // configuration (changed with config_mutex, read through a Snapshot)
+  std::mutex                    config_mutex;
+  std::unique_ptr<LogConfig>    config_owner;
+  std::atomic<const LogConfig*> config     = { nullptr };
+  std::atomic<uint32_t>         epoch      = { 0 };
+  std::atomic<uint32_t>         readers[2] = {};  // (index : epoch & 1)
+
+  // replaced snapshots : retired since the last epoch flip, or waiting for
+  // the readers of the previous epoch (waiting_index) to leave
+  std::mutex                              retired_mutex;
+  std::vector<std::unique_ptr<LogConfig>> retired;
+  std::vector<std::unique_ptr<LogConfig>> waiting;
+  uint32_t                                waiting_index = 0;
+  std::atomic<bool>                       retiring      = { false };
+
+  // overload policy (asynchronous mode)
+  std::atomic<Overload> overload         = { Overload::BLOCK };
+  std::atomic<uint32_t> overload_timeout = { 0 };  // milliseconds
+
+  // statistics
+  std::atomic<uint64_t> accepted   = { 0 };
+  std::atomic<uint64_t> dropped[8] = {};
+  std::atomic<uint64_t> bytes      = { 0 };
+  std::atomic<size_t>   peak_depth = { 0 };
+
+  // (destroyed - drained - before the other members)
+  AsyncContext async;
+
+  // (last member : stopped first)
+  ConfigWatcher watcher;
+
+  // count a reader on the current epoch (before the pointer is loaded),
+  // returns the counter index
+  uint32_t pin()
+  {
+    while (true) {
+      auto current = epoch.load();
+      readers[current & 1].fetch_add(1);
+      if (epoch.load() == current)
+        return current & 1;
+
+      // flipped meanwhile : counted again on the new epoch (nothing is freed
+      // here, pin is used in the crash handler)
+      readers[current & 1].fetch_sub(1);
+    }
+  }
+
+  // (true : last reader of the counter while snapshots are being retired)
+  bool unpin(uint32_t index)
+  {
+    return readers[index].fetch_sub(1) == 1 &&
+           retiring.load(std::memory_order_relaxed);
+  }
+
+  // current snapshot, pinned while the object lives
+  class Snapshot {
+   public:
+    explicit Snapshot(Context& context)
+        : context_(context), index_(context.pin())
+    {
+      config_ = context_.config.load();
+    }
+    ~Snapshot()
+    {
+      if (context_.unpin(index_))
+        context_.reclaim();
+    }
+
+    Snapshot(const Snapshot&)            = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    const LogConfig& operator*() const { return *config_; }
+    const LogConfig* operator->() const { return config_; }
+
+   private:
+    Context&         context_;
+    uint32_t         index_;
+    const LogConfig* config_;
+  };
+
+  Context()
+  {
+    config_owner        = std::make_unique<LogConfig>();
+    config_owner->names = { "console", "file" };
+    config_owner->sinks = { console, file };
+    config.store(config_owner.get());
+  }
+
+  Snapshot current() { return Snapshot(*this); }
+
+  // publish a changed copy of the current snapshot (false : not changed)
+  template <typename Change>
+  bool update(Change&& change)
+  {
+    {
+      std::unique_lock<std::mutex> ulock(config_mutex);
+
+      auto next = std::make_unique<LogConfig>(*config_owner);
+      if (change(*next) == false)
+        return false;
+
+      config.store(next.get());
+
+      std::unique_lock<std::mutex> retired_lock(retired_mutex);
+      retired.push_back(std::move(config_owner));
+      retiring.store(true, std::memory_order_relaxed);
+      config_owner = std::move(next);
+    }
+
+    reclaim();
+    return true;
+  }
+
+  // free the replaced snapshots nobody can read any more : the epoch is
+  // flipped after retiring, new readers count on the other counter, and the
+  // snapshots are freed once the previous counter drops to 0 (by its last
+  // reader or the next update)
+  void reclaim()
+  {
+    std::vector<std::unique_ptr<LogConfig>> unused;
+    {
+      std::unique_lock<std::mutex> ulock(retired_mutex, std::try_to_lock);
+      if (ulock.owns_lock() == false)
+        return;
+
+      if (waiting.empty() == false) {
+        if (readers[waiting_index].load() > 0)
+          return;
+        unused.swap(waiting);
+      }
+
+      if (retired.empty() == false) {
+        waiting.swap(retired);
+        waiting_index = epoch.fetch_add(1) & 1;
+        if (readers[waiting_index].load() == 0) {
+          for (auto& config : waiting)
+            unused.push_back(std::move(config));
+          waiting.clear();
+        }
+      }
+      retiring.store(waiting.empty() == false, std::memory_order_relaxed);
+    }
+    // (freed without the lock : sinks may be destroyed with the snapshot)
+  }
+
+  // write to the registered sinks (blocking or non-blocking sinks only)
+  void writeSinks(const LogConfig& config, const LogRecord& record,
+                  bool blocking)
+  {
+    for (auto& sink : config.sinks) {
+      if (sink->blocking() == blocking && sink->accepts(record.level))
+        sink->write(record);
+    }
+  }
+
+  void flushSinks(const LogConfig& config, bool blocking_only)
+  {
+    for (auto& sink : config.sinks) {
+      if (blocking_only == false || sink->blocking())
+        sink->flush();
+    }
+  }
+};
+
+// every constructed instance (level refresh of shared sinks)
+struct InstanceList {
+  std::mutex                     mutex;
+  std::vector<Logger::Instance*> instances;
+};
+
+static InstanceList& instanceList()
+{
+  static InstanceList list;
+  return list;
+}
+
+// named instances (never destroyed before exit)
+struct InstanceRegistry {
+  std::mutex                                                mutex;
+  std::map<std::string, std::unique_ptr<Logger::Instance>> instances;
+};
+
+static InstanceRegistry& instanceRegistry()
+{
+  static InstanceRegistry registry;
+  return registry;
+}
+
+// call-sites holding repeated records : "last message repeated N times" is
+// written once the repeat interval is over (LogFlusher timer), on flush and
+// when the instance is destroyed, even if no other message follows
+struct PendingRepeat {
+  LogThrottle*      throttle;
+  Logger::Instance* instance;
+  Logger::Level     level;
+  bool              raw;
+  const char*       file;
+  int               line;
+};
+
+struct PendingRepeats {
+  std::mutex                 mutex;
+  std::vector<PendingRepeat> entries;
+
+  PendingRepeats()
+  {
+    LogFlusher::add(this, [this] { report(nullptr); });
+  }
+  ~PendingRepeats() { LogFlusher::remove(this); }
+
+  void add(const PendingRepeat& entry)
+  {
+    {
+      std::unique_lock<std::mutex> ulock(mutex);
+      entries.push_back(entry);
+    }
+    LogFlusher::start();
+  }
+
+  // expired entries (nullptr) or every entry of the instance, written with
+  // the mutex held (an instance is not destroyed while its notice is written)
+  void report(Logger::Instance* instance)
+  {
+    std::unique_lock<std::mutex> ulock(mutex);
+
+    const auto now = LogThrottle::now();
+    for (size_t i = 0; i < entries.size();) {
+      auto entry = entries[i];
+      if (instance ? entry.instance != instance
+                   : entry.throttle->repeatExpired(now) == false) {
+        ++i;
+        continue;
+      }
+      entries[i] = entries.back();
+      entries.pop_back();
+
+      // (cleared first : a repeat counted from now on is registered again)
+      entry.throttle->clearPending();
+      struct Counts {
+        uint32_t repeated;
+        uint32_t suppressed;
+      } counts = { entry.throttle->takeRepeated(),
+                   entry.throttle->takeSuppressed() };
+      if (counts.repeated == 0)
+        continue;
+
+      entry.instance->write(
+          nullptr, entry.level, entry.raw, entry.file, entry.line,
+          [](FormatBuffer& buffer, FormatBuffer&, const void* context) {
+            auto counts = static_cast<const Counts*>(context);
+            buffer.printf("last message repeated %u times", counts->repeated);
+            if (counts->suppressed > 0)
+              buffer.printf(", %u messages suppressed", counts->suppressed);
+          },
+          &counts);
+    }
+  }
+};
+
+// (constructed before any instance : destroyed after them)
+PendingRepeats g_pending_repeats;
 
 Logger::Logger()
 {
   // constructor
-  memset(directory_, '\0', sizeof(directory_));
+}
+
+Logger::Instance& Logger::instance()
+{
+  static Instance instance("");
+  return instance;
+}
+
+Logger::Instance& Logger::get(const std::string& name)
+{
+  if (name.empty())
+    return instance();
+
+  auto&                        registry = instanceRegistry();
+  std::unique_lock<std::mutex> ulock(registry.mutex);
+
+  auto& instance = registry.instances[name];
+  if (instance == nullptr)
+    instance = std::make_unique<Instance>(name);
+  return *instance;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Options & Control
-void Logger::setDirectory(const std::string& _path)
+// Default instance (static API)
+// clang-format off
+void Logger::setDirectory(const std::string& path)             { instance().setDirectory(path); }
+void Logger::resetDirectory()                                  { instance().resetDirectory(); }
+void Logger::setLevel(Logger::Level level)                     { instance().setLevel(level); }
+void Logger::setTarget(Logger::Target target)                  { instance().setTarget(target); }
+void Logger::setTraceLogging(bool enable)                      { instance().setTraceLogging(enable); }
+void Logger::setHeaderDate(bool enable)                        { instance().setHeaderDate(enable); }
+void Logger::setFileSizeLimit(size_t bytes)                    { instance().setFileSizeLimit(bytes); }
+void Logger::setFilePreallocate(size_t bytes)                  { instance().setFilePreallocate(bytes); }
+void Logger::setFileCompression(bool enable)                   { instance().setFileCompression(enable); }
+void Logger::setFileRetention(uint64_t bytes)                  { instance().setFileRetention(bytes); }
+void Logger::setFileIndex(uint32_t records)                    { instance().setFileIndex(records); }
+void Logger::setConsoleColor(bool enable)                      { instance().setConsoleColor(enable); }
+void Logger::setAsyncLogging(bool enable, size_t capacity)     { instance().setAsyncLogging(enable, capacity); }
+void Logger::setOverloadPolicy(Overload policy, uint32_t timeout_ms) { instance().setOverloadPolicy(policy, timeout_ms); }
+Logger::Stats Logger::getStats()                               { return instance().getStats(); }
+void Logger::resetStats()                                      { instance().resetStats(); }
+void Logger::setSharedLogging(bool enable,
+                              const std::string& name)         { instance().setSharedLogging(enable, name); }
+bool Logger::loadConfig(const std::string& path)               { return instance().loadConfig(path); }
+void Logger::watchConfig(const std::string& path,
+                         uint32_t interval_ms)                 { instance().watchConfig(path, interval_ms); }
+void Logger::addSink(const std::string& name,
+                     std::shared_ptr<LogSink> sink)            { instance().addSink(name, std::move(sink)); }
+void Logger::removeSink(const std::string& name)               { instance().removeSink(name); }
+std::shared_ptr<LogSink> Logger::getSink(const std::string& name) { return instance().getSink(name); }
+// clang-format on
+
+void Logger::flush()
 {
-  std::unique_lock<std::mutex> ulock(g_mutex_loggerLock);
+  instance().flush();
 
-  auto path = getSafeDirectory(_path);
+  std::unique_lock<std::mutex> block(g_mutex_binaryLock);
+  g_binary_file.flush();
+}
 
-  auto it = directories_.find(path);
-  if (it != directories_.end()) {
-    // not increaes counting
-  }
-  else {
-    // first time ..
-    directories_.insert({ path, {} });
+void Logger::refreshLevels()
+{
+  auto&                        list = instanceList();
+  std::unique_lock<std::mutex> ulock(list.mutex);
+  for (auto instance : list.instances)
+    instance->refreshLevels();
+}
+
+void Logger::setThrottle(LogThrottle::Mode mode, uint32_t rate, uint32_t burst)
+{
+  LogThrottle::configure(mode, rate, burst);
+}
+
+void Logger::setRepeatSuppression(uint32_t interval_ms)
+{
+  LogThrottle::setRepeatInterval(interval_ms);
+}
+
+void Logger::log(Level level, bool raw, const char* file, int line,
+                 const char* format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  instance().vlog(nullptr, level, raw, file, line, format, args);
+  va_end(args);
+}
+
+void Logger::log(LogThrottle& throttle, Level level, bool raw,
+                 const char* file, int line, const char* format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  instance().vlog(&throttle, level, raw, file, line, format, args);
+  va_end(args);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Instance
+Logger::Instance::Instance(const std::string& name)
+    : name_(name), default_(name.empty()), context_(std::make_unique<Context>())
+{
+  applyOptions();
+
+  {
+    auto&                        list = instanceList();
+    std::unique_lock<std::mutex> ulock(list.mutex);
+    list.instances.push_back(this);
   }
+  refreshLevels();
+}
+
+Logger::Instance::~Instance()
+{
+  g_pending_repeats.report(this);
+
+  auto&                        list = instanceList();
+  std::unique_lock<std::mutex> ulock(list.mutex);
+  list.instances.erase(
+      std::remove(list.instances.begin(), list.instances.end(), this),
+      list.instances.end());
+}
+
+void Logger::Instance::setDirectory(const std::string& _path)
+{
+  flush();  // queued records belong to the previous directory
+
+  std::unique_lock<std::mutex> ulock(context_->mutex);
+
+  auto path = getSafeDirectory(_path);
+
+  context_->directories.insert(path);
 
   assertDirectory(path);
 }
 
-void Logger::resetDirectory()
+void Logger::Instance::resetDirectory()
 {
-  std::unique_lock<std::mutex> ulock(g_mutex_loggerLock);
+  flush();  // queued records belong to the previous directory
+
+  std::unique_lock<std::mutex> ulock(context_->mutex);
 
   auto path = getSafeDirectory(".");
 
-  auto it = directories_.find(path);
-  if (it != directories_.end()) {
-    // not increaes counting
-  }
-  else {
-    // first time ..
-    directories_.insert({ path, {} });
-  }
+  context_->directories.insert(path);
 
   assertDirectory(path);
 }
 
 // clang-format off
-void Logger::setLevel(Logger::Level level)    { option_logging_level_ = level; }
-void Logger::setTarget(Logger::Target target) { option_logging_target_ = target; }
-void Logger::setTraceLogging(bool enable)     { option_enable_tarce_logging_ = enable; }
-void Logger::setHeaderDate(bool enable)       { option_enable_header_date_ = enable; }
+void Logger::Instance::setLevel(Level level)        { context_->update([&](LogConfig& config) { config.level = level; return true; }); applyOptions(); }
+void Logger::Instance::setTarget(Target target)     { context_->update([&](LogConfig& config) { config.target = target; return true; }); applyOptions(); }
+void Logger::Instance::setTraceLogging(bool enable) { context_->update([&](LogConfig& config) { config.trace = enable; return true; }); applyOptions(); }
+void Logger::Instance::setHeaderDate(bool enable)   { context_->update([&](LogConfig& config) { config.header_date = enable; return true; }); }
 // clang-format on
 
-////////////////////////////////////////////////////////////////////////////////
-// implement
-void Logger::log(Level level, bool raw, const char* file, int line,
-                 const char* format, ...)
+void Logger::Instance::applyOptions()
 {
-  std::unique_lock<std::mutex> ulock(g_mutex_loggerLock);
+  auto config = context_->current();
 
-  // First logging (Before setDirectory)
-  if (directories_.empty()) {
-    auto path = getSafeDirectory(".");
-    directories_.insert({ path, {} });
-    assertDirectory(path);  // Logging with default directory
+  const bool console =
+      static_cast<int>(config->target) & static_cast<int>(Target::CONSOLE);
+  const bool file =
+      static_cast<int>(config->target) & static_cast<int>(Target::FILE);
+
+  const auto level = std::min(config->level, Level::DEBUG);
+
+  context_->console->setLevel(console ? level : Level::OFF);
+  context_->file->setLevel(file ? level : Level::OFF);
+
+  // trace log is written only to the file
+  context_->file->setLevelEnabled(Level::TRACE, file && config->trace);
+
+  if (auto shared = std::atomic_load(&context_->shared)) {
+    shared->setLevel(file ? level : Level::OFF);
+    shared->setLevelEnabled(Level::TRACE, file && config->trace);
   }
+}
 
-  auto& directory_info = directories_.at(directory_);
+void Logger::Instance::setSharedLogging(bool enable, const std::string& name)
+{
+  std::shared_ptr<SharedRingSink> sink;
+  if (enable) {
+    sink = std::make_shared<SharedRingSink>(name);
+    if (sink->isOpen() == false) {
+      std::cerr << "logger : cannot open shared ring " << name << std::endl;
+      return;
+    }
+  }
 
-  try {
-    const auto isConsole = [](const Target target) {
-      return static_cast<int>(target) & static_cast<int>(Target::CONSOLE);
-    };
-    const auto isFile = [](const Target target) {
-      return static_cast<int>(target) & static_cast<int>(Target::FILE);
-    };
+  flush();  // queued records belong to the previous output
+  std::atomic_store(&context_->shared, sink);
+  applyOptions();
 
-    bool write_console = false, write_file = false;
+  // the ring takes the place of the file sink
+  if (sink)
+    addSink("file", sink);
+  else
+    addSink("file", context_->file);
+}
 
-    if (level == Level::FATAL || level == Logger::Level::ERROR ||
-        level == Level::WARN || level == Level::INFO) {
-      if (level <= option_logging_level_) {
-        if (isConsole(option_logging_target_))
-          write_console = true;
-        if (isFile(option_logging_target_))
-          write_file = true;
-      }
+void Logger::Instance::refreshLevels()
+{
+  uint32_t mask = 0;
+
+  auto config = context_->current();
+  for (auto& sink : config->sinks)
+    mask |= sink->levels();
+
+  enabled_levels_.store(mask, std::memory_order_relaxed);
+  if (default_)
+    Logger::enabled_levels_.store(mask, std::memory_order_relaxed);
+}
+
+void Logger::Instance::setFileSizeLimit(size_t bytes)
+{
+  context_->file->setSizeLimit(bytes);
+}
+
+void Logger::Instance::setFilePreallocate(size_t bytes)
+{
+  context_->file->setPreallocate(bytes);
+}
+
+void Logger::Instance::setFileCompression(bool enable)
+{
+  context_->file->setCompression(enable);
+}
+
+void Logger::Instance::setFileRetention(uint64_t bytes)
+{
+  context_->file->setRetention(bytes);
+}
+
+void Logger::Instance::setFileIndex(uint32_t records)
+{
+  context_->file->setIndex(records);
+}
+
+void Logger::Instance::setConsoleColor(bool enable)
+{
+  context_->console->setColor(enable);
+}
+
+void Logger::Instance::setOverloadPolicy(Overload policy, uint32_t timeout_ms)
+{
+  context_->overload_timeout.store(timeout_ms, std::memory_order_relaxed);
+  context_->overload.store(policy, std::memory_order_relaxed);
+}
+
+Logger::Stats Logger::Instance::getStats() const
+{
+  Stats stats;
+  stats.accepted = context_->accepted.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < sizeof(stats.dropped) / sizeof(uint64_t); ++i)
+    stats.dropped[i] = context_->dropped[i].load(std::memory_order_relaxed);
+  stats.bytes            = context_->bytes.load(std::memory_order_relaxed);
+  stats.peak_queue_depth = context_->peak_depth.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void Logger::Instance::resetStats()
+{
+  context_->accepted.store(0, std::memory_order_relaxed);
+  for (auto& dropped : context_->dropped)
+    dropped.store(0, std::memory_order_relaxed);
+  context_->bytes.store(0, std::memory_order_relaxed);
+  context_->peak_depth.store(0, std::memory_order_relaxed);
+}
+
+void Logger::Instance::addSink(const std::string& name,
+                               std::shared_ptr<LogSink> sink)
+{
+  if (sink == nullptr)
+    return;
+
+  context_->update([&](LogConfig& config) {
+    auto it = std::find(config.names.begin(), config.names.end(), name);
+    if (it != config.names.end()) {
+      config.sinks[it - config.names.begin()] = std::move(sink);
     }
-    else if (level == Level::DEBUG) {
-      if (level <= option_logging_level_) {
-        if (isConsole(option_logging_target_))
-          write_console = true;
-        if (isFile(option_logging_target_))
-          write_file = true;
-      }
+    else {
+      config.names.push_back(name);
+      config.sinks.push_back(std::move(sink));
     }
-    else if (level == Level::TRACE && option_enable_tarce_logging_) {
-      if (isFile(option_logging_target_))
-        write_file = true;
+    return true;
+  });
+
+  refreshLevels();
+}
+
+void Logger::Instance::removeSink(const std::string& name)
+{
+  bool removed = context_->update([&](LogConfig& config) {
+    auto it = std::find(config.names.begin(), config.names.end(), name);
+    if (it == config.names.end())
+      return false;
+
+    config.sinks.erase(config.sinks.begin() + (it - config.names.begin()));
+    config.names.erase(it);
+    return true;
+  });
+
+  if (removed)
+    refreshLevels();
+}
+
+std::shared_ptr<LogSink> Logger::Instance::getSink(const std::string& name)
+{
+  auto config = context_->current();
+
+  auto it = std::find(config->names.begin(), config->names.end(), name);
+  if (it == config->names.end())
+    return nullptr;
+  return config->sinks[it - config->names.begin()];
+}
+
+void Logger::Instance::log(Level level, bool raw, const char* file, int line,
+                           const char* format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  vlog(nullptr, level, raw, file, line, format, args);
+  va_end(args);
+}
+
+void Logger::Instance::log(LogThrottle& throttle, Level level, bool raw,
+                           const char* file, int line, const char* format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  vlog(&throttle, level, raw, file, line, format, args);
+  va_end(args);
+}
+
+void Logger::Instance::vlog(LogThrottle* throttle, Level level, bool raw,
+                            const char* file, int line, const char* format,
+                            va_list args)
+{
+  struct Printf {
+    const char* format;
+    va_list     args;
+  } body;
+  body.format = format;
+  va_copy(body.args, args);
+
+  write(throttle, level, raw, file, line,
+        [](FormatBuffer& buffer, FormatBuffer&, const void* context) {
+          auto printf = static_cast<Printf*>(const_cast<void*>(context));
+          buffer.vprintf(printf->format, printf->args);
+        },
+        &body);
+  va_end(body.args);
+}
+
+void Logger::Instance::write(LogThrottle* throttle, Level level, bool raw,
+                             const char* file, int line, FormatCallback body,
+                             const void* context)
+{
+  if (isEnabled(level) == false)
+    return;
+
+  try {
+    // find sinks accepting this level
+    bool write_blocking = false, write_direct = false;
+
+    // (one snapshot routes & writes the record)
+    auto config = context_->current();
+    for (auto& sink : config->sinks) {
+      if (sink->accepts(level)) {
+        if (sink->blocking())
+          write_blocking = true;
+        else
+          write_direct = true;
+      }
     }
 
-    if (write_console == false && write_file == false)
+    if (write_blocking == false && write_direct == false)
       return;
 
-    ///////////
-    char content[LOGGER_BUFFER_SIZE];
+    // time
+    Timestamp& timestamp = g_timestamp;
+    timestamp.now();
 
-    std::unique_ptr<char[]> content_extend;
-    int                     extension_size = 0;
+    const struct tm& tm = timestamp.tm;
 
-    // make body
-    va_list args, args_temp;
-    va_start(args, format);
-    va_copy(args_temp, args);
-    auto content_sz = vsnprintf(NULL, 0, format, args_temp) + 512;
-    va_end(args_temp);
+    // make header : [timestamp] [LEVEL]
+    FormatBuffer& buffer = g_log_buffer;
+    buffer.clear();
 
-    if (content_sz > static_cast<decltype(content_sz)>(LOGGER_BUFFER_SIZE)) {
-      extension_size = content_sz;
-      content_extend = std::make_unique<char[]>(extension_size);
-      memset(content_extend.get(), 0, extension_size);
-      vsnprintf(content_extend.get(), extension_size, format, args);
-    }
-    else {
-      memset(content, 0, LOGGER_BUFFER_SIZE);
-      vsnprintf(content, LOGGER_BUFFER_SIZE, format, args);
+    if (raw == false) {
+      const char* prefix =
+          config->header_date ? timestamp.date_time : timestamp.time;
+
+      // "mmm] "
+      char millisecond[5];
+      millisecond[0] = static_cast<char>('0' + timestamp.millisecond / 100);
+      millisecond[1] = static_cast<char>('0' + timestamp.millisecond / 10 % 10);
+      millisecond[2] = static_cast<char>('0' + timestamp.millisecond % 10);
+      millisecond[3] = ']';
+      millisecond[4] = ' ';
+
+      buffer.append(prefix, strlen(prefix));
+      buffer.append(millisecond, sizeof(millisecond));
+      buffer.append(levelKeyword(level), 8);
     }
-    va_end(args);
 
-    // make header
-    struct tm tm;
-    char      timestamp[24];
+    size_t header_length = buffer.size();
 
-    if (raw == false) {
-#ifdef _WIN32
-      struct _timeb tb;
-      _ftime_s(&tb);
+    // make body (directly in the record buffer)
+    FormatBuffer& fields = g_field_buffer;
+    fields.clear();
+    body(buffer, fields, context);
 
-      localtime_s(&tm, &tb.time);
-#else
-      struct timeb tb;
-      ftime(&tb);
+    // structured fields are also shown in the text : message key=value ...
+    size_t message_length = buffer.size();
+    if (fields.size() > 0)
+      formatter::appendLogfmtFields(buffer, fields.data(), fields.size());
 
-      localtime_r(&tb.time, &tm);
-#endif
-      if (option_enable_header_date_) {
-        snprintf(timestamp, sizeof(timestamp),
-                 "%04d-%02d-%02d %02d:%02d:%02d.%03d", tm.tm_year + 1900,
-                 tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec,
-                 tb.millitm);
+    size_t body_length = buffer.size();
+
+    // call-site throttling : collapse repeated message & report suppressed
+    if (throttle) {
+      if (LogThrottle::repeatEnabled()) {
+        auto hash = messageHash(buffer.data() + header_length,
+                                body_length - header_length);
+        if (throttle->unique(hash, LogThrottle::now()) == false) {
+          if (throttle->markPending())
+            g_pending_repeats.add({ throttle, this, level, raw, file, line });
+          return;
+        }
       }
-      else {
-        snprintf(timestamp, sizeof(timestamp), "%02d:%02d:%02d.%03d",
-                 tm.tm_hour, tm.tm_min, tm.tm_sec, tb.millitm);
+
+      auto repeated   = throttle->takeRepeated();
+      auto suppressed = throttle->takeSuppressed();
+      if (repeated > 0 || suppressed > 0) {
+        char notice[256];
+        int  length = snprintf(notice, sizeof(notice), "%.*s",
+                               static_cast<int>(header_length), buffer.data());
+        int  body   = length;
+        if (repeated > 0)
+          length += snprintf(notice + length, sizeof(notice) - length,
+                             "last message repeated %u times%s", repeated,
+                             suppressed > 0 ? ", " : "");
+        if (suppressed > 0)
+          length += snprintf(notice + length, sizeof(notice) - length,
+                             "%u messages suppressed", suppressed);
+        int end = length;
+        length += snprintf(notice + length, sizeof(notice) - length,
+                           "   ... (%s: %d)\n", file ? file : "", line);
+        length = std::min<int>(length, sizeof(notice) - 1);
+
+        LogRecord record = { level, raw,    &tm,    timestamp.millisecond,
+                             file,  line,   notice, static_cast<size_t>(body),
+                             static_cast<size_t>(end),
+                             static_cast<size_t>(length),
+                             static_cast<size_t>(end),
+                             nullptr, 0 };
+        dispatch(*config, record, write_direct, write_blocking);
       }
     }
+
+    // make tail : ... (file: line)
+    if (raw == false) {
+      if (file && line > 0)
+        buffer.printf("   ... (%s: %d)\n", file, line);
+      else
+        buffer.append(" \n", 2);
+    }
     else {
-      memset(timestamp, 0, sizeof(timestamp));
-    }
-
-    // make tail
-    char logging_tail[256];
-    memset(logging_tail, '\0', sizeof(logging_tail));
-
-    if (file && line > 0 && raw == false) {
-      snprintf(logging_tail, sizeof(logging_tail), "  ... (%s: %d)", file,
-               line);
-    }
-
-    // make log level key
-    const char* keyword;
-    switch (level) {
-      case Level::FATAL:
-        keyword = "[FATAL]";
-        break;
-      case Level::ERROR:
-        keyword = "[ERROR]";
-        break;
-      case Level::WARN:
-        keyword = "[WARN]";
-        break;
-      case Level::INFO:
-        keyword = "[INFO]";
-        break;
-      case Level::DEBUG:
-        keyword = "[DEBUG]";
-        break;
-      case Level::TRACE:
-        keyword = "[TRACE]";
-        break;
-      default:
-        keyword = "";
-        break;
-    }
-    if (raw)
-      keyword = "";
-
-    // make content
-    char  content_console[LOGGER_BUFFER_SIZE];
-    char  content_file[LOGGER_BUFFER_SIZE];
-    char* content_console_ext = nullptr;
-    char* content_file_ext    = nullptr;
-    if (extension_size > 0) {
-      content_console_ext = new char[extension_size];
-      content_file_ext    = new char[extension_size];
-      memset(content_console_ext, 0, extension_size);
-      memset(content_file_ext, 0, extension_size);
-      if (raw == false) {
-        snprintf(content_console_ext, extension_size, "[%s] %-7s %s\n",
-                 timestamp, keyword, content_extend.get());
-        snprintf(content_file_ext, extension_size, "[%s] %-7s %s %s\n",
-                 timestamp, keyword, content_extend.get(), logging_tail);
-      }
-      else {
-        snprintf(content_console_ext, extension_size, "%s\n",
-                 content_extend.get());
-        snprintf(content_file_ext, extension_size, "%s\n",
-                 content_extend.get());
+      buffer.append("\n", 1);
+    }
+
+    LogRecord record = { level, raw,           &tm,         timestamp.millisecond,
+                         file,  line,          buffer.data(), header_length,
+                         body_length, buffer.size(), message_length,
+                         fields.data(), fields.size() };
+
+    dispatch(*config, record, write_direct, write_blocking);
+
+    if (level == Level::FATAL)
+      dumpFlightRecorder("fatal log");
+  }
+  catch (std::exception& e) {
+    std::cerr << "logger : exception : " << e.what() << std::endl;
+  }
+  catch (...) {
+    std::cerr << "logger : exception : undefined" << std::endl;
+  }
+}
+
+void Logger::Instance::dispatch(const LogConfig& config,
+                                const LogRecord& record, bool write_direct,
+                                bool write_blocking)
+{
+  auto& async = context_->async;
+
+  // non-blocking sinks : always from the logging thread
+  if (write_direct)
+    context_->writeSinks(config, record, false);
+
+  if (write_blocking == false) {
+    context_->accepted.fetch_add(1, std::memory_order_relaxed);
+    context_->bytes.fetch_add(record.length, std::memory_order_relaxed);
+    return;
+  }
+
+  // counted before `enabled` is read (seq_cst : setAsyncLogging clears
+  // `enabled`, then waits for the count to drop before touching the queue)
+  struct Producer {
+    std::atomic<uint32_t>& count;
+    ~Producer() { count.fetch_sub(1, std::memory_order_release); }
+  } producer = { async.producers };
+  async.producers.fetch_add(1);
+
+  if (async.enabled.load()) {
+    const auto policy = context_->overload.load(std::memory_order_relaxed);
+    const auto drop   = [&] {
+      context_->dropped[static_cast<int>(record.level)].fetch_add(
+          1, std::memory_order_relaxed);
+    };
+
+    // lower levels are dropped earlier :
+    // WARN at 7/8 of the queue, INFO 6/8, DEBUG 5/8, TRACE 4/8
+    if (policy == Overload::DROP_LOW_LEVELS && record.level >= Level::WARN) {
+      auto limit =
+          async.queue->capacity() * (10 - static_cast<int>(record.level)) / 8;
+      if (async.queue->size() >= limit) {
+        drop();
+        return;
       }
     }
-    else {
-      memset(content_console, 0, LOGGER_BUFFER_SIZE);
-      memset(content_file, 0, LOGGER_BUFFER_SIZE);
-      if (raw == false) {
-        snprintf(content_console, LOGGER_BUFFER_SIZE, "[%s] %-7s %s\n",
-                 timestamp, keyword, content);
-        snprintf(content_file, LOGGER_BUFFER_SIZE, "[%s] %-7s %s %s\n",
-                 timestamp, keyword, content, logging_tail);
+
+    // hand over to the writer thread (only copy under the queue slot, the
+    // level is set last : a slot left by a throwing copy is skipped)
+    const auto fill = [&](Record& queued) {
+      queued.level          = Level::OFF;
+      queued.raw            = record.raw;
+      queued.tm             = *record.tm;
+      queued.millisecond    = record.millisecond;
+      queued.line           = record.line;
+      queued.header_length  = record.header_length;
+      queued.body_length    = record.body_length;
+      queued.message_length = record.message_length;
+      queued.file.assign(record.file ? record.file : "");
+      queued.content.assign(record.content, record.length);
+      queued.fields.assign(record.fields ? record.fields : "",
+                           record.fields_length);
+      queued.level = record.level;
+    };
+
+    std::chrono::steady_clock::time_point deadline;
+    if (policy == Overload::BLOCK_TIMEOUT) {
+      deadline = std::chrono::steady_clock::now() +
+                 std::chrono::milliseconds(context_->overload_timeout.load(
+                     std::memory_order_relaxed));
+    }
+
+    int spins = 0;
+    while (async.queue->tryPush(fill) == false) {
+      // queue is full : drop (not a fatal/error record) or wait for writer
+      if (policy == Overload::DROP_NEW ||
+          (policy == Overload::DROP_LOW_LEVELS &&
+           record.level >= Level::WARN) ||
+          (policy == Overload::BLOCK_TIMEOUT &&
+           std::chrono::steady_clock::now() >= deadline)) {
+        async.notify();
+        drop();
+        return;
       }
-      else {
-        snprintf(content_console, LOGGER_BUFFER_SIZE, "%s\n", content);
-        snprintf(content_file, LOGGER_BUFFER_SIZE, "%s\n", content);
+      async.notify();
+
+      // short spin, then sleep until the writer pops (no CPU taken from it)
+      if (++spins < 64) {
+        std::this_thread::yield();
+        continue;
       }
+      async.waitSpace(policy == Overload::BLOCK_TIMEOUT
+                          ? deadline
+                          : std::chrono::steady_clock::time_point::max());
     }
+    async.pushed.fetch_add(1, std::memory_order_release);
 
-    ////////////////////////////////////////////////
-    if (write_file) {
-      // Log saving path
-      char file_dir[260];
-      snprintf(file_dir, sizeof(file_dir), "%s/%04d_%02d_%02d", directory_,
-               tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+    // peak queue depth
+    auto depth = async.queue->size();
+    auto peak  = context_->peak_depth.load(std::memory_order_relaxed);
+    while (depth > peak && !context_->peak_depth.compare_exchange_weak(
+                               peak, depth, std::memory_order_relaxed)) {
+    }
 
-      bool state_changed = false;
+    if (async.sleeping.load(std::memory_order_acquire))
+      async.notify();
+  }
+  else {
+    assertDefaultDirectory();
+    context_->writeSinks(config, record, true);
+  }
 
-      // If save path is not exist, generate ..
-#ifdef _WIN32
-      auto st = GetFileAttributes(file_dir);
-      if (st == INVALID_FILE_ATTRIBUTES || !(st & FILE_ATTRIBUTE_DIRECTORY)) {
-        _mkdir(file_dir);
-        directory_info.same_time_files = 0;
+  context_->accepted.fetch_add(1, std::memory_order_relaxed);
+  context_->bytes.fetch_add(record.length, std::memory_order_relaxed);
+}
+
+// configuration file value parsers (false : invalid)
+static bool parseLevel(const std::string& value, Logger::Level& level)
+{
+  static const char* names[] = { "off",  "fatal", "error", "warn",
+                                 "info", "debug", "trace" };
+  for (int i = 0; i < 7; ++i) {
+    if (value == names[i]) {
+      level = static_cast<Logger::Level>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool parseTarget(const std::string& value, Logger::Target& target)
+{
+  if (value == "console")
+    target = Logger::Target::CONSOLE;
+  else if (value == "file")
+    target = Logger::Target::FILE;
+  else if (value == "console_file")
+    target = Logger::Target::CONSOLE_FILE;
+  else
+    return false;
+  return true;
+}
+
+static bool parseBool(const std::string& value, bool& enable)
+{
+  if (value == "true" || value == "on" || value == "1")
+    enable = true;
+  else if (value == "false" || value == "off" || value == "0")
+    enable = false;
+  else
+    return false;
+  return true;
+}
+
+static bool parseFormat(const std::string& value, LogSink::Format& format)
+{
+  static const char* names[] = { "full", "short", "message", "json",
+                                 "logfmt" };
+  for (int i = 0; i < 5; ++i) {
+    if (value == names[i]) {
+      format = static_cast<LogSink::Format>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+static std::string trim(const std::string& text)
+{
+  auto begin = text.find_first_not_of(" \t\r");
+  if (begin == std::string::npos)
+    return std::string();
+  auto end = text.find_last_not_of(" \t\r");
+  return text.substr(begin, end - begin + 1);
+}
+
+bool Logger::Instance::loadConfig(const std::string& path)
+{
+  std::ifstream file(path);
+  if (file.is_open() == false) {
+    std::cerr << "logger : cannot open config " << path << std::endl;
+    return false;
+  }
+
+  // parse all lines first (nothing is applied on error)
+  LogConfig   options       = *context_->current();
+  bool        set_directory = false;
+  std::string directory;
+
+  std::vector<std::pair<std::shared_ptr<LogSink>, Level>>           levels;
+  std::vector<std::pair<std::shared_ptr<LogSink>, LogSink::Format>> formats;
+
+  std::string line;
+  int         number = 0;
+  bool        valid  = true;
+  while (std::getline(file, line)) {
+    number++;
+    line = trim(line.substr(0, line.find('#')));
+    if (line.empty())
+      continue;
+
+    auto separator = line.find('=');
+    auto key       = trim(line.substr(0, separator));
+    auto value     = separator == std::string::npos
+                         ? std::string()
+                         : trim(line.substr(separator + 1));
+    auto lower     = value;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+
+    bool ok = true;
+    if (separator == std::string::npos) {
+      ok = false;
+    }
+    else if (key == "level") {
+      ok = parseLevel(lower, options.level);
+    }
+    else if (key == "target") {
+      ok = parseTarget(lower, options.target);
+    }
+    else if (key == "trace") {
+      ok = parseBool(lower, options.trace);
+    }
+    else if (key == "header_date") {
+      ok = parseBool(lower, options.header_date);
+    }
+    else if (key == "directory") {
+      set_directory = true;
+      directory     = value;
+    }
+    else if (key.compare(0, 5, "sink.") == 0) {
+      // sink.{name}.level, sink.{name}.format
+      auto dot  = key.rfind('.');
+      auto sink = getSink(key.substr(5, dot - 5));
+      auto item = key.substr(dot + 1);
+
+      Level           level;
+      LogSink::Format format;
+      if (sink == nullptr || dot <= 5) {
+        ok = false;
       }
-#else
-      struct stat st;
-      if (stat(file_dir, &st) != 0 || !S_ISDIR(st.st_mode)) {
-        mkdir(file_dir, 0777);
-        directories_.at(directory_).same_time_files = 0;
+      else if (item == "level" && parseLevel(lower, level)) {
+        levels.emplace_back(sink, level);
       }
-#endif
+      else if (item == "format" && parseFormat(lower, format)) {
+        formats.emplace_back(sink, format);
+      }
+      else {
+        ok = false;
+      }
+    }
+    else {
+      ok = false;
+    }
 
-      // Check counting state
-      // 1. Logging Path is changed
-      // in setDirector & resetDirectory
+    if (ok == false) {
+      std::cerr << "logger : invalid config (" << path << ": " << number
+                << ") " << line << std::endl;
+      valid = false;
+    }
+  }
 
-      // 2. Logging Time(hour) is changed
-      if (directory_info.previous_time != tm.tm_hour) {
-        directory_info.previous_time = tm.tm_hour;
-        state_changed                = true;
-      }
+  if (valid == false)
+    return false;
 
-      if (state_changed) {
-        char file_time[14];
-        snprintf(file_time, sizeof(file_time), "%04d_%02d_%02d-%02d",
-                 tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour);
+  // options are switched at once (single snapshot)
+  context_->update([&](LogConfig& config) {
+    config.level       = options.level;
+    config.target      = options.target;
+    config.trace       = options.trace;
+    config.header_date = options.header_date;
+    return true;
+  });
+  applyOptions();
 
-        directory_info.same_time_files = [file_dir, file_time]() {
-#ifdef _WIN32
-          int              file_count = 0;
-          WIN32_FIND_DATAA file_data;
-          HANDLE           handle;
-
-          std::string path = std::string(file_dir) + "/*";
-          handle           = FindFirstFile(path.c_str(), &file_data);
-          if (handle != INVALID_HANDLE_VALUE) {
-            do {
-              if (!(file_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
-                if (strstr(file_data.cFileName, file_time)) {
-                  file_count++;
-                }
-              }
-            } while (FindNextFile(handle, &file_data));
-            FindClose(handle);
-          }
-#else
-          int            file_count = 0;
-          DIR*           dirp       = nullptr;
-          struct dirent* entry;
-
-          dirp = opendir(file_dir);
-
-          while ((entry = readdir(dirp)) != NULL) {
-            if (entry->d_type == DT_REG) {
-              if (strstr(entry->d_name, file_time)) {
-                file_count++;
-              }
-            }
-          }
-          closedir(dirp);
-#endif
-          return file_count;
-        }();
-      }
+  for (auto& item : levels)
+    item.first->setLevel(item.second);
+  for (auto& item : formats)
+    item.first->setFormat(item.second);
+
+  if (set_directory &&
+      getSafeDirectory(directory) != context_->current()->directory)
+    setDirectory(directory);
 
-      FILE* logger_file = nullptr;
+  return true;
+}
 
-      char filepath[280];
-      snprintf(filepath, sizeof(filepath), "%s/%04d_%02d_%02d-%02d-%02d.txt",
-               file_dir, tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
-               tm.tm_hour, directory_info.same_time_files + 1);
+// modification time of a file (0 : not exist)
+static int64_t modifiedTime(const std::string& path)
+{
 #ifdef _WIN32
-      fopen_s(&logger_file, filepath, "a");
+  struct _stat st;
+  if (_stat(path.c_str(), &st) != 0)
+    return 0;
 #else
-      logger_file = fopen(filepath, "a");
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0)
+    return 0;
 #endif
-      if (logger_file) {
-        if (extension_size > 0)
-          fprintf(logger_file, "%s", content_file_ext);
-        else
-          fprintf(logger_file, "%s", content_file);
-        fclose(logger_file);
-      }
-    }
+  return static_cast<int64_t>(st.st_mtime);
+}
 
-    if (write_console) {
-      if (extension_size > 0)
-        printf("%s", content_console_ext);
-      else
-        printf("%s", content_console);
-    }
+void Logger::Instance::watchConfig(const std::string& path,
+                                   uint32_t           interval_ms)
+{
+  auto& watcher = context_->watcher;
+  watcher.shutdown();
+  if (interval_ms == 0)
+    return;
+
+  watcher.stop   = false;
+  watcher.thread = std::thread([this, path, interval_ms] {
+    auto& watcher  = context_->watcher;
+    auto  modified = modifiedTime(path);
+    loadConfig(path);
 
-    if (extension_size > 0) {
-      delete[] content_console_ext;
-      content_console_ext = nullptr;
+    std::unique_lock<std::mutex> ulock(watcher.mutex);
+    while (watcher.convar.wait_for(ulock,
+                                   std::chrono::milliseconds(interval_ms),
+                                   [&watcher] { return watcher.stop; }) ==
+           false) {
+      auto time = modifiedTime(path);
+      if (time == modified)
+        continue;
 
-      delete[] content_file_ext;
-      content_file_ext = nullptr;
+      modified = time;
+      ulock.unlock();
+      loadConfig(path);
+      ulock.lock();
     }
+  });
+}
+
+void Logger::Instance::assertDefaultDirectory()
+{
+  if (context_->directory_ready.load(std::memory_order_acquire))
+    return;
+
+  // First logging (Before setDirectory)
+  std::unique_lock<std::mutex> ulock(context_->mutex);
+  if (context_->directories.empty()) {
+    auto path = getSafeDirectory(".");
+    context_->directories.insert(path);
+    assertDirectory(path);  // Logging with default directory
   }
-  catch (std::exception& e) {
-    std::cerr << "logger : exception : " << e.what() << std::endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// asynchronous writer
+void Logger::Instance::setAsyncLogging(bool enable, size_t queue_capacity)
+{
+  auto&                        async = context_->async;
+  std::unique_lock<std::mutex> control_lock(async.control_mutex);
+
+  if (enable == async.enabled.load())
+    return;
+
+  if (enable) {
+    // (no producer is left on the old queue : quiesced when disabled)
+    if (async.queue == nullptr || async.queue->capacity() < queue_capacity)
+      async.queue = std::make_unique<MPSCQueue<Record>>(queue_capacity);
+
+    async.stop = false;
+    async.running.store(true, std::memory_order_release);
+    async.enabled.store(true, std::memory_order_release);
+    async.thread = std::thread(&Instance::runAsyncWriter, this);
   }
-  catch (...) {
-    std::cerr << "logger : exception : undefined" << std::endl;
+  else {
+    // records pushed until the producers quiesce are drained on stop
+    async.enabled.store(false);
+    async.quiesce();
+    async.shutdown();
   }
 }
 
-std::string Logger::extractClass(const std::string& pretty_function)
+void Logger::Instance::flush()
 {
-  std::string pretty_func = pretty_function;
-  removeLambda(pretty_func);
+  g_pending_repeats.report(this);
 
-  // find method start point
-  size_t method_start = pretty_func.find("(");
-  if (method_start == std::string::npos)
-    return pretty_func;
-  else
-    pretty_func = pretty_func.substr(0, method_start + 1);
+  auto& async = context_->async;
 
-  size_t colons = pretty_func.rfind("::");
-  if (colons == std::string::npos)
-    return "(NO CLASS)";
-  else {  // include namespace
-    size_t colons_prev, begin;
-    if ((colons_prev = pretty_func.rfind("::", colons - 1)) ==
-        std::string::npos)
-      begin = pretty_func.rfind(" ", colons) + 1;
-    else
-      begin = colons_prev + 2;  // 2: length of "::"
-    return pretty_func.substr(begin, colons - begin);
+  if (async.running.load(std::memory_order_acquire)) {
+    const auto target = async.pushed.load(std::memory_order_acquire);
+
+    std::unique_lock<std::mutex> ulock(async.wait_mutex);
+    async.convar.notify_all();
+    async.flushed.wait(ulock, [&async, target] {
+      return async.written.load(std::memory_order_acquire) >= target ||
+             async.running.load(std::memory_order_acquire) == false;
+    });
   }
+
+  context_->flushSinks(*context_->current(), false);
 }
 
-std::string Logger::extractMethod(const std::string& pretty_function)
+void Logger::Instance::runAsyncWriter()
 {
-  std::string pretty_func = pretty_function;
-  removeLambda(pretty_func);
+  auto& async = context_->async;
 
-  // find method start point
-  size_t method_start = pretty_func.find("(");
-  if (method_start == std::string::npos)
-    return pretty_func;
-  else
-    pretty_func = pretty_func.substr(0, method_start + 1);
+  const auto drain = [this, &async] {
+    auto   config = context_->current();  // (one snapshot per batch)
+    size_t count  = 0;
+    while (async.queue->tryPop([this, &config](Record& queued) {
+      if (queued.level == Level::OFF)
+        return;  // not completely copied
 
-  size_t colons, begin;
-  if ((colons = pretty_func.rfind("::")) == std::string::npos)
-    begin = pretty_func.rfind(" ", colons) + 1;
-  else
-    begin = colons + 2;
-  size_t end = pretty_func.rfind("(") - begin;
-  return pretty_func.substr(begin, end) + "()";
+      LogRecord record = { queued.level,
+                           queued.raw,
+                           &queued.tm,
+                           queued.millisecond,
+                           queued.file.empty() ? nullptr : queued.file.c_str(),
+                           queued.line,
+                           queued.content.data(),
+                           queued.header_length,
+                           queued.body_length,
+                           queued.content.size(),
+                           queued.message_length,
+                           queued.fields.data(),
+                           queued.fields.size() };
+
+      assertDefaultDirectory();
+      context_->writeSinks(*config, record, true);
+    })) {
+      async.written.fetch_add(1, std::memory_order_release);
+      if (++count % 64 == 0)
+        async.notifySpace();
+    }
+    async.notifySpace();
+    if (count > 0) {
+      // queue is drained : write out buffered data
+      context_->flushSinks(*config, true);
+    }
+    return count;
+  };
+
+  while (true) {
+    drain();
+
+    std::unique_lock<std::mutex> ulock(async.wait_mutex);
+    async.flushed.notify_all();
+
+    if (async.stop)
+      break;
+
+    // sleep until producer wakes up (timeout prevents lost wake-up)
+    async.sleeping.store(true, std::memory_order_release);
+    if (async.queue->empty())
+      async.convar.wait_for(ulock, std::chrono::milliseconds(10));
+    async.sleeping.store(false, std::memory_order_release);
+  }
+
+  // drain records pushed while stopping
+  drain();
+
+  std::unique_lock<std::mutex> ulock(async.wait_mutex);
+  async.running.store(false, std::memory_order_release);
+  async.flushed.notify_all();
 }
 
-std::string Logger::getSafeDirectory(const std::string& path)
+std::string Logger::Instance::getSafeDirectory(const std::string& path) const
 {
-  return ((path.empty() ? "." : path) + "/log/");
+  // named instance : sub directory of its name
+  return Logger::getSafeDirectory(path) +
+         (default_ ? std::string() : name_ + "/");
 }
 
-void Logger::assertDirectory(const std::string& path)
+void Logger::Instance::assertDirectory(const std::string& path)
 {
   // If folder is exist : return
 #ifdef _WIN32
@@ -452,32 +1506,291 @@ void Logger::assertDirectory(const std::string& path)
 #endif
 
   // Make directory (recursive)
-  std::string temp_path;
-  std::size_t pos = 0;
-  while ((pos = path.find_first_of("/", pos + 1)) != std::string::npos) {
-    temp_path = path.substr(0, pos);
+  LogFile::makeDirectory(path);
+
+  // assing path
+  context_->update([&](LogConfig& config) {
+    config.directory = path;
+    return true;
+  });
+  context_->file->setDirectory(path);
+  if (default_) {
+    std::unique_lock<std::mutex> block(g_mutex_binaryLock);
+    g_binary_file.setDirectory(path);
+  }
+  context_->directory_ready.store(true, std::memory_order_release);
+#ifdef _DEBUG
+  std::cout << "Logger Directory : " << path << std::endl;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// flight recorder
+struct FlightRecorder {
+  std::mutex                             mutex;
+  std::vector<std::shared_ptr<RingSink>> sinks;  // kept for signal handler
+  std::atomic<RingSink*>                 current = { nullptr };
+  std::atomic_bool                       dumping = { false };
+  bool                                   handled = false;
+};
+
+FlightRecorder g_flight;
+
+#ifdef _WIN32
+static const int CRASH_SIGNALS[] = { SIGSEGV, SIGABRT, SIGFPE, SIGILL };
+#else
+static const int CRASH_SIGNALS[] = { SIGSEGV, SIGABRT, SIGFPE, SIGILL, SIGBUS };
+#endif
 #ifdef _WIN32
-    _mkdir(temp_path.c_str());
+static void (*g_previous_handlers[sizeof(CRASH_SIGNALS) / sizeof(int)])(int);
 #else
-    mkdir(temp_path.c_str(), 0777);
+static struct sigaction g_previous_handlers[sizeof(CRASH_SIGNALS) / sizeof(int)];
+#endif
+
+static void onCrashSignal(int signal)
+{
+  // clang-format off
+  const char* reason = "signal";
+  switch (signal) {
+    case SIGSEGV: reason = "SIGSEGV"; break;
+    case SIGABRT: reason = "SIGABRT"; break;
+    case SIGFPE: reason = "SIGFPE"; break;
+    case SIGILL: reason = "SIGILL"; break;
+#ifndef _WIN32
+    case SIGBUS: reason = "SIGBUS"; break;
 #endif
   }
+  // clang-format on
+  Logger::dumpFlightRecorder(reason);
 
-  // assing path
-  snprintf(directory_, sizeof(directory_), "%s", path.c_str());
-#ifdef _DEBUG
-  std::cout << "Logger Directory : " << directory_ << std::endl;
+  // continue with the previous handler (default : terminate)
+  for (size_t i = 0; i < sizeof(CRASH_SIGNALS) / sizeof(int); ++i) {
+    if (CRASH_SIGNALS[i] != signal)
+      continue;
+#ifdef _WIN32
+    ::signal(signal, g_previous_handlers[i]);
+#else
+    sigaction(signal, &g_previous_handlers[i], nullptr);
+#endif
+  }
+  raise(signal);
+}
+
+// decimal digits (async-signal-safe)
+static size_t appendNumber(char* out, size_t capacity, size_t pos,
+                           uint64_t value)
+{
+  char   digits[20];
+  size_t count = 0;
+  do {
+    digits[count++] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  } while (value > 0);
+
+  while (count > 0 && pos + 1 < capacity)
+    out[pos++] = digits[--count];
+  return pos;
+}
+
+static size_t appendText(char* out, size_t capacity, size_t pos,
+                         const char* text)
+{
+  while (*text && pos + 1 < capacity)
+    out[pos++] = *text++;
+  return pos;
+}
+
+void Logger::setFlightRecorder(bool enable, size_t capacity,
+                               size_t record_size)
+{
+  std::unique_lock<std::mutex> ulock(g_flight.mutex);
+
+  if (enable == false) {
+    g_flight.current.store(nullptr);
+    instance().removeSink("flight");
+    return;
+  }
+
+  auto sink = std::make_shared<RingSink>(capacity, record_size);
+  sink->setLevel(Level::TRACE);  // every level
+  g_flight.sinks.push_back(sink);
+  g_flight.current.store(sink.get());
+  instance().addSink("flight", sink);
+  instance().assertDefaultDirectory();
+
+  if (g_flight.handled == false) {
+    g_flight.handled = true;
+    for (size_t i = 0; i < sizeof(CRASH_SIGNALS) / sizeof(int); ++i) {
+#ifdef _WIN32
+      g_previous_handlers[i] = ::signal(CRASH_SIGNALS[i], onCrashSignal);
+#else
+      struct sigaction action;
+      memset(&action, 0, sizeof(action));
+      action.sa_handler = onCrashSignal;
+      sigemptyset(&action.sa_mask);
+      sigaction(CRASH_SIGNALS[i], &action, &g_previous_handlers[i]);
 #endif
+    }
+  }
 }
 
-void Logger::removeLambda(std::string& pretty_func)
+void Logger::dumpFlightRecorder(const char* reason)
 {
-  std::string lambda_key("::<lambda()>");
-  size_t      colons = pretty_func.find(lambda_key);
-  if (colons != std::string::npos) {
-    pretty_func.erase(colons, lambda_key.length());
+  auto sink = g_flight.current.load();
+  if (sink == nullptr || g_flight.dumping.exchange(true))
+    return;
+
+  // {directory}/flight-{epoch}-{pid}.txt (no allocation : signal handler,
+  // the snapshot is pinned without Snapshot as it may free on release)
+  auto&       context   = *instance().context_;
+  auto        pinned    = context.pin();
+  const char* directory = context.config.load()->directory.c_str();
+
+  char   path[4096 + 64];
+  size_t pos = appendText(path, sizeof(path), 0, directory);
+  context.unpin(pinned);
+  pos        = appendText(path, sizeof(path), pos, "flight-");
+  pos = appendNumber(path, sizeof(path), pos, static_cast<uint64_t>(time(0)));
+  pos = appendText(path, sizeof(path), pos, "-");
+#ifdef _WIN32
+  pos = appendNumber(path, sizeof(path), pos, _getpid());
+#else
+  pos = appendNumber(path, sizeof(path), pos, getpid());
+#endif
+  pos       = appendText(path, sizeof(path), pos, ".txt");
+  path[pos] = '\0';
+
+  char   title[128];
+  size_t length = appendText(title, sizeof(title), 0, "==== flight recorder (");
+  length        = appendText(title, sizeof(title), length, reason);
+  length        = appendText(title, sizeof(title), length, ") ====\n");
+
+#ifdef _WIN32
+  int fd = _open(path, _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY,
+                 _S_IREAD | _S_IWRITE);
+  if (fd >= 0) {
+    _write(fd, title, static_cast<unsigned int>(length));
+    sink->dump(fd);
+    _close(fd);
   }
+#else
+  int fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  if (fd >= 0) {
+    if (write(fd, title, length) > 0)
+      sink->dump(fd);
+    close(fd);
+  }
+#endif
+
+  g_flight.dumping.store(false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// binary logging
+static std::atomic<uint32_t> g_binary_format_id = { 0 };
+
+binlog::Format::Format(int level, const char* fmt, const char* file, int line)
+    : id(++g_binary_format_id), level(level), fmt(fmt), file(file), line(line)
+{
+}
+
+void Logger::setBinaryLogging(bool enable)
+{
+  instance().assertDefaultDirectory();
+  option_enable_binary_logging_.store(enable, std::memory_order_relaxed);
 }
+
+void Logger::writeBinary(const binlog::Format& format, const char* payload,
+                         size_t size)
+{
+  using namespace std::chrono;
+  uint64_t time_ns =
+      duration_cast<nanoseconds>(system_clock::now().time_since_epoch())
+          .count();
+
+  Timestamp& timestamp = g_timestamp;
+  timestamp.update(static_cast<int64_t>(time_ns / 1000000));
+  const struct tm& tm = timestamp.tm;
+
+  // (an idle process is flushed by the timer)
+  LogFlusher::start();
+
+  // record : kind(1) id(4) time_ns(8) payload_len(2) payload
+  char record[1 + 4 + 8 + 2 + binlog::MAX_PAYLOAD];
+  auto kind        = static_cast<uint8_t>(binlog::Kind::RECORD);
+  auto payload_len = static_cast<uint16_t>(size);
+  memcpy(record, &kind, 1);
+  memcpy(record + 1, &format.id, 4);
+  memcpy(record + 5, &time_ns, 8);
+  memcpy(record + 13, &payload_len, 2);
+  if (size > 0)
+    memcpy(record + 15, payload, size);
+
+  std::unique_lock<std::mutex> ulock(g_mutex_binaryLock);
+
+  if (g_binary_file.prepare(tm, 15 + size) == false)
+    return;
+
+  // new file : header & format definitions are written again
+  static uint32_t file_sequence = 0;
+  if (file_sequence != g_binary_file.sequence()) {
+    file_sequence = g_binary_file.sequence();
+
+    char header[8];
+    header[0] = static_cast<char>(binlog::Kind::FILE_HEADER);
+    memcpy(header + 1, binlog::MAGIC, 7);
+    g_binary_file.write(tm, header, sizeof(header));
+  }
+
+  if (format.file_sequence != file_sequence) {
+    format.file_sequence = file_sequence;
+
+    // format : kind(1) id(4) level(1) line(4) fmt_len(2) file_len(2) fmt file
+    char definition[14 + 4096];
+    auto fmt_len  = static_cast<uint16_t>(strnlen(format.fmt, 3840));
+    auto file_len =
+        static_cast<uint16_t>(format.file ? strnlen(format.file, 256) : 0);
+    auto    def_kind = static_cast<uint8_t>(binlog::Kind::FORMAT);
+    auto    level    = static_cast<uint8_t>(format.level);
+    int32_t line     = format.line;
+    memcpy(definition, &def_kind, 1);
+    memcpy(definition + 1, &format.id, 4);
+    memcpy(definition + 5, &level, 1);
+    memcpy(definition + 6, &line, 4);
+    memcpy(definition + 10, &fmt_len, 2);
+    memcpy(definition + 12, &file_len, 2);
+    memcpy(definition + 14, format.fmt, fmt_len);
+    memcpy(definition + 14 + fmt_len, format.file, file_len);
+    g_binary_file.write(tm, definition, 14 + fmt_len + file_len);
+  }
+
+  g_binary_file.write(tm, record, 15 + size);
+
+  if (static_cast<Level>(format.level) <= Level::ERROR)
+    g_binary_file.flush();
+}
+
+std::string Logger::extractClass(const std::string& pretty_function)
+{
+  std::string name(pretty_function.size() + FunctionName::PADDING, '\0');
+  name.resize(FunctionName::parse(pretty_function, FunctionName::Kind::CLASS,
+                                  &name[0]));
+  return name;
+}
+
+std::string Logger::extractMethod(const std::string& pretty_function)
+{
+  std::string name(pretty_function.size() + FunctionName::PADDING, '\0');
+  name.resize(FunctionName::parse(pretty_function, FunctionName::Kind::METHOD,
+                                  &name[0]));
+  return name;
+}
+
+std::string Logger::getSafeDirectory(const std::string& path)
+{
+  return ((path.empty() ? "." : path) + "/log/");
+}
+
 }  // namespace rs
 
 #ifdef _WIN32
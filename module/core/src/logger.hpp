@@ -1,26 +1,69 @@
 #ifndef __ROWEN_SDK_CORE_LOGGER_HPP__
 #define __ROWEN_SDK_CORE_LOGGER_HPP__
 
+#include <atomic>
+#include <cstdarg>
+#include <ctime>
+#include <memory>
 #include <string>
-#include <unordered_map>
+#include <type_traits>
+
+#include "binaryLog.hpp"
+#include "functionName.hpp"
+#include "logFormat.hpp"
+#include "logThrottle.hpp"
+
+// Compile-time log level : more verbose statements are compiled out
+// (0:OFF 1:FATAL 2:ERROR 3:WARN 4:INFO 5:DEBUG 6:TRACE)
+#ifndef ROWEN_LOG_MIN_LEVEL
+  #define ROWEN_LOG_MIN_LEVEL 6
+#endif
 
 namespace rs {
 
+class LogSink;
+struct LogRecord;
+struct LogConfig;
+
 class Logger {
  public:
   enum class Level { OFF, FATAL, ERROR, WARN, INFO, DEBUG, TRACE, RAW };
   enum class Target { CONSOLE = 1, FILE, CONSOLE_FILE };
 
-  struct Directory {
-    int same_time_files = 0;
-    int previous_time   = -1;
+  // writes the message of a record into the buffer (after the header) and
+  // its structured fields (formatter::appendField)
+  using FormatCallback = void (*)(FormatBuffer& buffer, FormatBuffer& fields,
+                                  const void* context);
+
+  // Behavior when the asynchronous queue is full
+  enum class Overload {
+    BLOCK,            // wait for the writer (no record is lost)
+    DROP_NEW,         // drop the new record
+    DROP_LOW_LEVELS,  // drop TRACE ~ WARN as the queue fills (lower first)
+    BLOCK_TIMEOUT,    // wait up to the timeout, then drop
+  };
+
+  struct Stats {
+    uint64_t accepted         = 0;   // records written or queued
+    uint64_t dropped[8]       = {};  // dropped records (index : Level)
+    uint64_t bytes            = 0;   // formatted bytes of accepted records
+    size_t   peak_queue_depth = 0;   // asynchronous mode
   };
 
+  // Named logger : own directory, options, sinks and writer thread
+  class Instance;
+
  public:
   Logger();
 
+  // Default logger (used by the static API & logger_* macros)
+  static Instance& instance();
+
+  // Named logger, created on the first call ({directory}/log/{name})
+  static Instance& get(const std::string& name);
+
   //////////////////////////
-  // Options & Control
+  // Options & Control (default logger)
 
   // If want to change directory (default : ./log)
   static void setDirectory(const std::string& logging_directory);
@@ -38,52 +81,368 @@ class Logger {
   // Enable header date information
   static void setHeaderDate(bool enable);
 
+  // Rotate log file when it exceeds the size limit (default 0 : unlimited)
+  static void setFileSizeLimit(size_t bytes);
+
+  // Preallocate disk blocks of each new log file (Linux, default 0 : disabled)
+  static void setFilePreallocate(size_t bytes);
+
+  // Compress rotated log files in the background (requires zlib)
+  static void setFileCompression(bool enable);
+
+  // Delete the oldest day directories when the log directory exceeds the
+  // budget (default 0 : unlimited)
+  static void setFileRetention(uint64_t bytes);
+
+  // Write a sidecar index of each log file ({file}.idx) for log_query,
+  // one entry every `records` records and on flush (default 0 : disabled)
+  static void setFileIndex(uint32_t records);
+
+  // Color the console records by level (terminal only, default : disabled)
+  static void setConsoleColor(bool enable);
+
+  // Enable asynchronous logging (file & console output on a writer thread)
+  static void setAsyncLogging(bool enable, size_t queue_capacity = 8192);
+
+  // Overload policy of the asynchronous queue (default : BLOCK)
+  static void setOverloadPolicy(Overload policy, uint32_t timeout_ms = 0);
+
+  // Counters since start (or resetStats)
+  static Stats getStats();
+  static void  resetStats();
+
+  // Enable binary logging of logger_bin_* statements (YYYY_MM_DD-HH-NN.bin)
+  static void setBinaryLogging(bool enable);
+
+  // Rate limit of each logger_* call-site (file & line)
+  //  - TOKEN_BUCKET : `rate` records per second, bursts up to `burst` records
+  //  - SAMPLING     : 1 of every `rate` records
+  static void setThrottle(LogThrottle::Mode mode, uint32_t rate = 0,
+                          uint32_t burst = 1);
+
+  // Collapse identical records of a logger_* call-site into
+  // "last message repeated N times", written with the next distinct record
+  // or once the interval is over (0 : disabled)
+  static void setRepeatSuppression(uint32_t interval_ms);
+
+  // Keep the latest records of every level in memory (lock-free), dumped to
+  // {directory}/flight-{epoch}-{pid}.txt on crash signals & fatal log
+  static void setFlightRecorder(bool enable, size_t capacity = 1024,
+                                size_t record_size = 256);
+  static void dumpFlightRecorder(const char* reason);
+
+  // Wait until all queued log records are written and flush the sinks
+  static void flush();
+
+  // Send records to a shared memory ring instead of the log files, written
+  // by a single collector (LogCollector, tools/log-collector) for every
+  // process (POSIX only)
+  static void setSharedLogging(bool enable,
+                               const std::string& name = "/rowen-log");
+
+  // Apply options from a configuration file ("key = value", '#' comment)
+  //   level, target (console|file|console_file), trace, header_date,
+  //   directory, sink.{name}.level, sink.{name}.format (full|short|message|
+  //   json|logfmt)
+  // nothing is applied if a line is invalid (false)
+  static bool loadConfig(const std::string& path);
+
+  // Reload the configuration file whenever it is modified (0 : stop)
+  static void watchConfig(const std::string& path, uint32_t interval_ms = 1000);
+
+  //////////////////////////
+  // Sinks ("console" & "file" are registered by default)
+
+  // Register or replace a sink
+  static void addSink(const std::string& name, std::shared_ptr<LogSink> sink);
+  static void removeSink(const std::string& name);
+
+  // Get registered sink (nullptr if not exist)
+  static std::shared_ptr<LogSink> getSink(const std::string& name);
+
+  // Recalculate enabled levels of every logger (after changing sink levels)
+  static void refreshLevels();
+
   //////////////////////////
 
   // clang-format off
   // wrapper
-  template <typename... Args> static void fatal(const char* fmt, Args... args)  { log(Level::FATAL, false, nullptr, 0, fmt, args...); }
-  template <typename... Args> static void error(const char* fmt, Args... args)  { log(Level::ERROR, false, nullptr, 0, fmt, args...); }
-  template <typename... Args> static void warn(const char* fmt, Args... args)   { log(Level::WARN,  false, nullptr, 0, fmt, args...); }
-  template <typename... Args> static void info(const char* fmt, Args... args)   { log(Level::INFO,  false, nullptr, 0, fmt, args...); }
-  template <typename... Args> static void debug(const char* fmt, Args... args)  { log(Level::DEBUG, false, nullptr, 0, fmt, args...); }
-  template <typename... Args> static void trace(const char* fmt, Args... args)  { log(Level::TRACE, false, nullptr, 0, fmt, args...); }
+  template <typename... Args> static void fatal(const char* fmt, Args... args)  { if (isEnabled(Level::FATAL)) log(Level::FATAL, false, nullptr, 0, fmt, args...); }
+  template <typename... Args> static void error(const char* fmt, Args... args)  { if (isEnabled(Level::ERROR)) log(Level::ERROR, false, nullptr, 0, fmt, args...); }
+  template <typename... Args> static void warn(const char* fmt, Args... args)   { if (isEnabled(Level::WARN)) log(Level::WARN,  false, nullptr, 0, fmt, args...); }
+  template <typename... Args> static void info(const char* fmt, Args... args)   { if (isEnabled(Level::INFO)) log(Level::INFO,  false, nullptr, 0, fmt, args...); }
+  template <typename... Args> static void debug(const char* fmt, Args... args)  { if (isEnabled(Level::DEBUG)) log(Level::DEBUG, false, nullptr, 0, fmt, args...); }
+  template <typename... Args> static void trace(const char* fmt, Args... args)  { if (isEnabled(Level::TRACE)) log(Level::TRACE, false, nullptr, 0, fmt, args...); }
 
  public:
   // wrapper (no time-line & file location)
-  template <typename... Args> static void fatal_raw(const char* fmt, Args... args)  { log(Level::FATAL, true, nullptr, 0, fmt, args...); }
-  template <typename... Args> static void error_raw(const char* fmt, Args... args)  { log(Level::ERROR, true, nullptr, 0, fmt, args...); }
-  template <typename... Args> static void warn_raw(const char* fmt, Args... args)   { log(Level::WARN,  true, nullptr, 0, fmt, args...); }
-  template <typename... Args> static void info_raw(const char* fmt, Args... args)   { log(Level::INFO,  true, nullptr, 0, fmt, args...); }
-  template <typename... Args> static void debug_raw(const char* fmt, Args... args)  { log(Level::DEBUG, true, nullptr, 0, fmt, args...); }
-  template <typename... Args> static void trace_raw(const char* fmt, Args... args)  { log(Level::TRACE, true, nullptr, 0, fmt, args...); }
+  template <typename... Args> static void fatal_raw(const char* fmt, Args... args)  { if (isEnabled(Level::FATAL)) log(Level::FATAL, true, nullptr, 0, fmt, args...); }
+  template <typename... Args> static void error_raw(const char* fmt, Args... args)  { if (isEnabled(Level::ERROR)) log(Level::ERROR, true, nullptr, 0, fmt, args...); }
+  template <typename... Args> static void warn_raw(const char* fmt, Args... args)   { if (isEnabled(Level::WARN)) log(Level::WARN,  true, nullptr, 0, fmt, args...); }
+  template <typename... Args> static void info_raw(const char* fmt, Args... args)   { if (isEnabled(Level::INFO)) log(Level::INFO,  true, nullptr, 0, fmt, args...); }
+  template <typename... Args> static void debug_raw(const char* fmt, Args... args)  { if (isEnabled(Level::DEBUG)) log(Level::DEBUG, true, nullptr, 0, fmt, args...); }
+  template <typename... Args> static void trace_raw(const char* fmt, Args... args)  { if (isEnabled(Level::TRACE)) log(Level::TRACE, true, nullptr, 0, fmt, args...); }
+
+ public:
+  // wrapper (compile-time checked format : RS_FMT("x={}"))
+  template <typename S, typename... Args, typename = std::enable_if_t<formatter::isString<S>>> static void fatal(S fmt, const Args&... args)  { if (isEnabled(Level::FATAL)) print(nullptr, Level::FATAL, false, nullptr, 0, fmt, args...); }
+  template <typename S, typename... Args, typename = std::enable_if_t<formatter::isString<S>>> static void error(S fmt, const Args&... args)  { if (isEnabled(Level::ERROR)) print(nullptr, Level::ERROR, false, nullptr, 0, fmt, args...); }
+  template <typename S, typename... Args, typename = std::enable_if_t<formatter::isString<S>>> static void warn(S fmt, const Args&... args)   { if (isEnabled(Level::WARN)) print(nullptr, Level::WARN,  false, nullptr, 0, fmt, args...); }
+  template <typename S, typename... Args, typename = std::enable_if_t<formatter::isString<S>>> static void info(S fmt, const Args&... args)   { if (isEnabled(Level::INFO)) print(nullptr, Level::INFO,  false, nullptr, 0, fmt, args...); }
+  template <typename S, typename... Args, typename = std::enable_if_t<formatter::isString<S>>> static void debug(S fmt, const Args&... args)  { if (isEnabled(Level::DEBUG)) print(nullptr, Level::DEBUG, false, nullptr, 0, fmt, args...); }
+  template <typename S, typename... Args, typename = std::enable_if_t<formatter::isString<S>>> static void trace(S fmt, const Args&... args)  { if (isEnabled(Level::TRACE)) print(nullptr, Level::TRACE, false, nullptr, 0, fmt, args...); }
+
+ public:
+  // wrapper (structured : message & kv("key", value) fields)
+  template <typename... Fields, typename = std::enable_if_t<(sizeof...(Fields) > 0)>> static void fatal(const char* message, const KeyValue<Fields>&... fields)  { if (isEnabled(Level::FATAL)) structured(nullptr, Level::FATAL, nullptr, 0, message, fields...); }
+  template <typename... Fields, typename = std::enable_if_t<(sizeof...(Fields) > 0)>> static void error(const char* message, const KeyValue<Fields>&... fields)  { if (isEnabled(Level::ERROR)) structured(nullptr, Level::ERROR, nullptr, 0, message, fields...); }
+  template <typename... Fields, typename = std::enable_if_t<(sizeof...(Fields) > 0)>> static void warn(const char* message, const KeyValue<Fields>&... fields)   { if (isEnabled(Level::WARN)) structured(nullptr, Level::WARN,  nullptr, 0, message, fields...); }
+  template <typename... Fields, typename = std::enable_if_t<(sizeof...(Fields) > 0)>> static void info(const char* message, const KeyValue<Fields>&... fields)   { if (isEnabled(Level::INFO)) structured(nullptr, Level::INFO,  nullptr, 0, message, fields...); }
+  template <typename... Fields, typename = std::enable_if_t<(sizeof...(Fields) > 0)>> static void debug(const char* message, const KeyValue<Fields>&... fields)  { if (isEnabled(Level::DEBUG)) structured(nullptr, Level::DEBUG, nullptr, 0, message, fields...); }
+  template <typename... Fields, typename = std::enable_if_t<(sizeof...(Fields) > 0)>> static void trace(const char* message, const KeyValue<Fields>&... fields)  { if (isEnabled(Level::TRACE)) structured(nullptr, Level::TRACE, nullptr, 0, message, fields...); }
   // clang-format on
 
  public:
   static void log(Level level, bool raw, const char* file, int line,
                   const char* fmt, ...);
+  static void log(LogThrottle& throttle, Level level, bool raw,
+                  const char* file, int line, const char* fmt, ...);
 
+  // "{}" format parsed at compile-time, arguments converted without printf
+  template <typename S, typename... Args>
+  static void print(LogThrottle* throttle, Level level, bool raw,
+                    const char* file, int line, S fmt, const Args&... args);
+
+  // message & fields, encoded without allocation (text, JSON or logfmt sink)
+  template <typename... Fields>
+  static void structured(LogThrottle* throttle, Level level, const char* file,
+                         int line, const char* message,
+                         const KeyValue<Fields>&... fields);
+
+  // check before formatting (compile-time level & runtime level, lock-free)
+  static bool isEnabled(Level level)
+  {
+    return static_cast<int>(level) <= ROWEN_LOG_MIN_LEVEL &&
+           (enabled_levels_.load(std::memory_order_relaxed) &
+            (1u << static_cast<int>(level)));
+  }
+
+  // binary record : format id & raw arguments (text log if disabled)
+  template <typename... Args>
+  static void binary(const binlog::Format& format, Args... args)
+  {
+    auto level   = static_cast<Level>(format.level);
+    bool enabled = option_enable_binary_logging_.load(std::memory_order_relaxed);
+    if (enabled == false) {
+      log(level, false, format.file, format.line, format.fmt,
+          binlog::printable(args)...);
+      return;
+    }
+
+    if (isEnabled(level) == false)
+      return;
+
+    if constexpr (sizeof...(Args) > 0) {
+      char            payload[binlog::MAX_PAYLOAD];
+      binlog::Encoder encoder(payload, sizeof(payload));
+      (encoder.put(args), ...);
+      writeBinary(format, payload, encoder.size());
+    }
+    else {
+      writeBinary(format, nullptr, 0);
+    }
+  }
+
+  // runtime version of __CLASS__ & __METHOD__
   static std::string extractClass(const std::string& prettyFunction);
   static std::string extractMethod(const std::string& prettyFunction);
 
+  struct Record;
+
  private:
+  static void writeBinary(const binlog::Format& format, const char* payload,
+                          size_t size);
+
   static std::string getSafeDirectory(const std::string& path);
-  static void        assertDirectory(const std::string& path);
-  static void        removeLambda(std::string& prettyFunction);
 
  private:
-  static Level  option_logging_level_;
-  static Target option_logging_target_;
-  static bool   option_enable_tarce_logging_;
-  static bool   option_enable_header_date_;
+  static std::atomic<bool> option_enable_binary_logging_;
+
+  // bit mask of levels written to any target (default logger)
+  static std::atomic<uint32_t> enabled_levels_;
+};
+
+class Logger::Instance {
+ public:
+  explicit Instance(const std::string& name);
+  ~Instance();
+
+  Instance(const Instance&)            = delete;
+  Instance& operator=(const Instance&) = delete;
+
+  const std::string& name() const { return name_; }
+
+  //////////////////////////
+  // Options & Control (same as the static API)
+  void setDirectory(const std::string& logging_directory);
+  void resetDirectory();
+  void setLevel(Level level);
+  void setTarget(Target target);
+  void setTraceLogging(bool enable);
+  void setHeaderDate(bool enable);
+  void setFileSizeLimit(size_t bytes);
+  void setFilePreallocate(size_t bytes);
+  void setFileCompression(bool enable);
+  void setFileRetention(uint64_t bytes);
+  void setFileIndex(uint32_t records);
+  void setConsoleColor(bool enable);
+  void setAsyncLogging(bool enable, size_t queue_capacity = 8192);
+  void setOverloadPolicy(Overload policy, uint32_t timeout_ms = 0);
+  void flush();
+
+  void setSharedLogging(bool enable, const std::string& name = "/rowen-log");
+  bool loadConfig(const std::string& path);
+  void watchConfig(const std::string& path, uint32_t interval_ms = 1000);
+
+  Stats getStats() const;
+  void  resetStats();
+
+  void addSink(const std::string& name, std::shared_ptr<LogSink> sink);
+  void removeSink(const std::string& name);
+  std::shared_ptr<LogSink> getSink(const std::string& name);
+  void                     refreshLevels();
+
+  //////////////////////////
+
+  // clang-format off
+  // wrapper
+  template <typename... Args> void fatal(const char* fmt, Args... args)  { if (isEnabled(Level::FATAL)) log(Level::FATAL, false, nullptr, 0, fmt, args...); }
+  template <typename... Args> void error(const char* fmt, Args... args)  { if (isEnabled(Level::ERROR)) log(Level::ERROR, false, nullptr, 0, fmt, args...); }
+  template <typename... Args> void warn(const char* fmt, Args... args)   { if (isEnabled(Level::WARN)) log(Level::WARN,  false, nullptr, 0, fmt, args...); }
+  template <typename... Args> void info(const char* fmt, Args... args)   { if (isEnabled(Level::INFO)) log(Level::INFO,  false, nullptr, 0, fmt, args...); }
+  template <typename... Args> void debug(const char* fmt, Args... args)  { if (isEnabled(Level::DEBUG)) log(Level::DEBUG, false, nullptr, 0, fmt, args...); }
+  template <typename... Args> void trace(const char* fmt, Args... args)  { if (isEnabled(Level::TRACE)) log(Level::TRACE, false, nullptr, 0, fmt, args...); }
+
+  // wrapper (no time-line & file location)
+  template <typename... Args> void fatal_raw(const char* fmt, Args... args)  { if (isEnabled(Level::FATAL)) log(Level::FATAL, true, nullptr, 0, fmt, args...); }
+  template <typename... Args> void error_raw(const char* fmt, Args... args)  { if (isEnabled(Level::ERROR)) log(Level::ERROR, true, nullptr, 0, fmt, args...); }
+  template <typename... Args> void warn_raw(const char* fmt, Args... args)   { if (isEnabled(Level::WARN)) log(Level::WARN,  true, nullptr, 0, fmt, args...); }
+  template <typename... Args> void info_raw(const char* fmt, Args... args)   { if (isEnabled(Level::INFO)) log(Level::INFO,  true, nullptr, 0, fmt, args...); }
+  template <typename... Args> void debug_raw(const char* fmt, Args... args)  { if (isEnabled(Level::DEBUG)) log(Level::DEBUG, true, nullptr, 0, fmt, args...); }
+  template <typename... Args> void trace_raw(const char* fmt, Args... args)  { if (isEnabled(Level::TRACE)) log(Level::TRACE, true, nullptr, 0, fmt, args...); }
+
+  // wrapper (compile-time checked format : RS_FMT("x={}"))
+  template <typename S, typename... Args, typename = std::enable_if_t<formatter::isString<S>>> void fatal(S fmt, const Args&... args)  { if (isEnabled(Level::FATAL)) print(nullptr, Level::FATAL, false, nullptr, 0, fmt, args...); }
+  template <typename S, typename... Args, typename = std::enable_if_t<formatter::isString<S>>> void error(S fmt, const Args&... args)  { if (isEnabled(Level::ERROR)) print(nullptr, Level::ERROR, false, nullptr, 0, fmt, args...); }
+  template <typename S, typename... Args, typename = std::enable_if_t<formatter::isString<S>>> void warn(S fmt, const Args&... args)   { if (isEnabled(Level::WARN)) print(nullptr, Level::WARN,  false, nullptr, 0, fmt, args...); }
+  template <typename S, typename... Args, typename = std::enable_if_t<formatter::isString<S>>> void info(S fmt, const Args&... args)   { if (isEnabled(Level::INFO)) print(nullptr, Level::INFO,  false, nullptr, 0, fmt, args...); }
+  template <typename S, typename... Args, typename = std::enable_if_t<formatter::isString<S>>> void debug(S fmt, const Args&... args)  { if (isEnabled(Level::DEBUG)) print(nullptr, Level::DEBUG, false, nullptr, 0, fmt, args...); }
+  template <typename S, typename... Args, typename = std::enable_if_t<formatter::isString<S>>> void trace(S fmt, const Args&... args)  { if (isEnabled(Level::TRACE)) print(nullptr, Level::TRACE, false, nullptr, 0, fmt, args...); }
+
+  // wrapper (structured : message & kv("key", value) fields)
+  template <typename... Fields, typename = std::enable_if_t<(sizeof...(Fields) > 0)>> void fatal(const char* message, const KeyValue<Fields>&... fields)  { if (isEnabled(Level::FATAL)) structured(nullptr, Level::FATAL, nullptr, 0, message, fields...); }
+  template <typename... Fields, typename = std::enable_if_t<(sizeof...(Fields) > 0)>> void error(const char* message, const KeyValue<Fields>&... fields)  { if (isEnabled(Level::ERROR)) structured(nullptr, Level::ERROR, nullptr, 0, message, fields...); }
+  template <typename... Fields, typename = std::enable_if_t<(sizeof...(Fields) > 0)>> void warn(const char* message, const KeyValue<Fields>&... fields)   { if (isEnabled(Level::WARN)) structured(nullptr, Level::WARN,  nullptr, 0, message, fields...); }
+  template <typename... Fields, typename = std::enable_if_t<(sizeof...(Fields) > 0)>> void info(const char* message, const KeyValue<Fields>&... fields)   { if (isEnabled(Level::INFO)) structured(nullptr, Level::INFO,  nullptr, 0, message, fields...); }
+  template <typename... Fields, typename = std::enable_if_t<(sizeof...(Fields) > 0)>> void debug(const char* message, const KeyValue<Fields>&... fields)  { if (isEnabled(Level::DEBUG)) structured(nullptr, Level::DEBUG, nullptr, 0, message, fields...); }
+  template <typename... Fields, typename = std::enable_if_t<(sizeof...(Fields) > 0)>> void trace(const char* message, const KeyValue<Fields>&... fields)  { if (isEnabled(Level::TRACE)) structured(nullptr, Level::TRACE, nullptr, 0, message, fields...); }
+  // clang-format on
+
+  void log(Level level, bool raw, const char* file, int line, const char* fmt,
+           ...);
+  void log(LogThrottle& throttle, Level level, bool raw, const char* file,
+           int line, const char* fmt, ...);
+  void vlog(LogThrottle* throttle, Level level, bool raw, const char* file,
+            int line, const char* fmt, va_list args);
+
+  // "{}" format parsed at compile-time, arguments converted without printf
+  template <typename S, typename... Args>
+  void print(LogThrottle* throttle, Level level, bool raw, const char* file,
+             int line, S fmt, const Args&... args)
+  {
+    (void)fmt;  // type only
+    const std::tuple<const Args&...> tuple(args...);
+    write(throttle, level, raw, file, line,
+          [](FormatBuffer& buffer, FormatBuffer&, const void* context) {
+            formatter::formatTo<S>(
+                buffer, *static_cast<const std::tuple<const Args&...>*>(context));
+          },
+          &tuple);
+  }
+
+  // message & fields, encoded without allocation (text, JSON or logfmt sink)
+  template <typename... Fields>
+  void structured(LogThrottle* throttle, Level level, const char* file,
+                  int line, const char* message,
+                  const KeyValue<Fields>&... fields)
+  {
+    const std::tuple<const char*, const KeyValue<Fields>&...> tuple(message,
+                                                                     fields...);
+    write(throttle, level, false, file, line,
+          [](FormatBuffer& buffer, FormatBuffer& encoded, const void* context) {
+            auto& args = *static_cast<
+                const std::tuple<const char*, const KeyValue<Fields>&...>*>(
+                context);
+            formatter::write(buffer, std::get<0>(args));
+            std::apply(
+                [&](const char*, const KeyValue<Fields>&... fields) {
+                  (formatter::appendField(encoded, fields), ...);
+                },
+                args);
+          },
+          &tuple);
+  }
+
+  // record with a custom body writer (header, tail & dispatch by the logger)
+  void write(LogThrottle* throttle, Level level, bool raw, const char* file,
+             int line, FormatCallback body, const void* context);
+
+  // check before formatting (compile-time level & runtime level, lock-free)
+  bool isEnabled(Level level) const
+  {
+    return static_cast<int>(level) <= ROWEN_LOG_MIN_LEVEL &&
+           (enabled_levels_.load(std::memory_order_relaxed) &
+            (1u << static_cast<int>(level)));
+  }
+
+ private:
+  friend class Logger;
+  struct Context;
+
+  void dispatch(const LogConfig& config, const LogRecord& record,
+                bool write_direct, bool write_blocking);
+  void assertDefaultDirectory();
+  void runAsyncWriter();
+  void applyOptions();
+
+  std::string getSafeDirectory(const std::string& path) const;
+  void        assertDirectory(const std::string& path);
+
+ private:
+  const std::string name_;
+  const bool        default_;
 
-  static char                                       directory_[260];
-  static std::unordered_map<std::string, Directory> directories_;
+  // bit mask of levels written to any sink
+  std::atomic<uint32_t> enabled_levels_ = { 0 };
 
-  static unsigned int startup_count_;
-  static int          previous_hour_;
+  std::unique_ptr<Context> context_;
 };
 
+template <typename S, typename... Args>
+void Logger::print(LogThrottle* throttle, Level level, bool raw,
+                   const char* file, int line, S fmt, const Args&... args)
+{
+  instance().print(throttle, level, raw, file, line, fmt, args...);
+}
+
+template <typename... Fields>
+void Logger::structured(LogThrottle* throttle, Level level, const char* file,
+                        int line, const char* message,
+                        const KeyValue<Fields>&... fields)
+{
+  instance().structured(throttle, level, file, line, message, fields...);
+}
+
 };  // namespace rs
 
 static rs::Logger logger;
@@ -94,16 +453,98 @@ static rs::Logger logger;
 
 #define __FILENAME__ \
   (strrchr(__FILE__, '/') ? strrchr(__FILE__, '/') + 1 : __FILE__)
-#define __CLASS__  (rs::Logger::extractClass(__PRETTY_FUNCTION__).c_str())
-#define __METHOD__ (rs::Logger::extractMethod(__PRETTY_FUNCTION__).c_str())
+
+// class or method name of the current function (parsed at compile-time,
+// once at runtime where the size of __PRETTY_FUNCTION__ is unknown)
+// clang-format off
+#if defined(__GNUC__) || defined(__clang__)
+  #define __ROWEN_FUNCTION_NAME(kind) __extension__({ static constexpr rs::StaticFunctionName<std::remove_reference_t<decltype(__PRETTY_FUNCTION__)>> __rs_function_name(__PRETTY_FUNCTION__, kind); static const auto& __rs_function_value = __rs_function_name.value(); __rs_function_value.c_str(); })
+  #define __CLASS__  __ROWEN_FUNCTION_NAME(rs::FunctionName::Kind::CLASS)
+  #define __METHOD__ __ROWEN_FUNCTION_NAME(rs::FunctionName::Kind::METHOD)
+#else
+  #define __CLASS__  (rs::Logger::extractClass(__PRETTY_FUNCTION__).c_str())
+  #define __METHOD__ (rs::Logger::extractMethod(__PRETTY_FUNCTION__).c_str())
+#endif
+// clang-format on
 
 // clang-format off
-#define logger_fatal(fmt, ...) rs::Logger::log(rs::Logger::Level::FATAL, false, __FILENAME__, __LINE__, (const char*)fmt, ##__VA_ARGS__)
-#define logger_error(fmt, ...) rs::Logger::log(rs::Logger::Level::ERROR, false, __FILENAME__, __LINE__, (const char*)fmt, ##__VA_ARGS__)
-#define logger_warn(fmt, ...)  rs::Logger::log(rs::Logger::Level::WARN,  false, __FILENAME__, __LINE__, (const char*)fmt, ##__VA_ARGS__)
-#define logger_info(fmt, ...)  rs::Logger::log(rs::Logger::Level::INFO,  false, __FILENAME__, __LINE__, (const char*)fmt, ##__VA_ARGS__)
-#define logger_debug(fmt, ...) rs::Logger::log(rs::Logger::Level::DEBUG, false, __FILENAME__, __LINE__, (const char*)fmt, ##__VA_ARGS__)
-#define logger_trace(fmt, ...) rs::Logger::log(rs::Logger::Level::TRACE, false, __FILENAME__, __LINE__, (const char*)fmt, ##__VA_ARGS__)
+#define __ROWEN_LOG(level, fmt, ...)     do { static rs::LogThrottle __rs_log_throttle; if (rs::Logger::isEnabled(level) && __rs_log_throttle.pass()) rs::Logger::log(__rs_log_throttle, level, false, __FILENAME__, __LINE__, (const char*)fmt, ##__VA_ARGS__); } while (0)
+#define __ROWEN_LOG_BIN(level, fmt, ...) do { if (rs::Logger::isEnabled(level)) { static const rs::binlog::Format __rs_binlog_format(static_cast<int>(level), fmt, __FILENAME__, __LINE__); rs::Logger::binary(__rs_binlog_format, ##__VA_ARGS__); } } while (0)
+#define __ROWEN_LOG_FMT(level, fmt, ...) do { static rs::LogThrottle __rs_log_throttle; if (rs::Logger::isEnabled(level) && __rs_log_throttle.pass()) rs::Logger::print(&__rs_log_throttle, level, false, __FILENAME__, __LINE__, RS_FMT(fmt), ##__VA_ARGS__); } while (0)
+#define __ROWEN_LOG_KV(level, msg, ...)  do { static rs::LogThrottle __rs_log_throttle; if (rs::Logger::isEnabled(level) && __rs_log_throttle.pass()) rs::Logger::structured(&__rs_log_throttle, level, __FILENAME__, __LINE__, msg, __VA_ARGS__); } while (0)
+#define __ROWEN_LOG_NONE()               do { } while (0)
+
+#if ROWEN_LOG_MIN_LEVEL >= 1
+  #define logger_fatal(fmt, ...)     __ROWEN_LOG(rs::Logger::Level::FATAL, fmt, ##__VA_ARGS__)
+  #define logger_bin_fatal(fmt, ...) __ROWEN_LOG_BIN(rs::Logger::Level::FATAL, fmt, ##__VA_ARGS__)
+  #define logger_fmt_fatal(fmt, ...) __ROWEN_LOG_FMT(rs::Logger::Level::FATAL, fmt, ##__VA_ARGS__)
+  #define logger_kv_fatal(msg, ...)  __ROWEN_LOG_KV(rs::Logger::Level::FATAL, msg, __VA_ARGS__)
+#else
+  #define logger_fatal(fmt, ...)     __ROWEN_LOG_NONE()
+  #define logger_bin_fatal(fmt, ...) __ROWEN_LOG_NONE()
+  #define logger_fmt_fatal(fmt, ...) __ROWEN_LOG_NONE()
+  #define logger_kv_fatal(msg, ...)  __ROWEN_LOG_NONE()
+#endif
+
+#if ROWEN_LOG_MIN_LEVEL >= 2
+  #define logger_error(fmt, ...)     __ROWEN_LOG(rs::Logger::Level::ERROR, fmt, ##__VA_ARGS__)
+  #define logger_bin_error(fmt, ...) __ROWEN_LOG_BIN(rs::Logger::Level::ERROR, fmt, ##__VA_ARGS__)
+  #define logger_fmt_error(fmt, ...) __ROWEN_LOG_FMT(rs::Logger::Level::ERROR, fmt, ##__VA_ARGS__)
+  #define logger_kv_error(msg, ...)  __ROWEN_LOG_KV(rs::Logger::Level::ERROR, msg, __VA_ARGS__)
+#else
+  #define logger_error(fmt, ...)     __ROWEN_LOG_NONE()
+  #define logger_bin_error(fmt, ...) __ROWEN_LOG_NONE()
+  #define logger_fmt_error(fmt, ...) __ROWEN_LOG_NONE()
+  #define logger_kv_error(msg, ...)  __ROWEN_LOG_NONE()
+#endif
+
+#if ROWEN_LOG_MIN_LEVEL >= 3
+  #define logger_warn(fmt, ...)      __ROWEN_LOG(rs::Logger::Level::WARN, fmt, ##__VA_ARGS__)
+  #define logger_bin_warn(fmt, ...)  __ROWEN_LOG_BIN(rs::Logger::Level::WARN, fmt, ##__VA_ARGS__)
+  #define logger_fmt_warn(fmt, ...)  __ROWEN_LOG_FMT(rs::Logger::Level::WARN, fmt, ##__VA_ARGS__)
+  #define logger_kv_warn(msg, ...)   __ROWEN_LOG_KV(rs::Logger::Level::WARN, msg, __VA_ARGS__)
+#else
+  #define logger_warn(fmt, ...)      __ROWEN_LOG_NONE()
+  #define logger_bin_warn(fmt, ...)  __ROWEN_LOG_NONE()
+  #define logger_fmt_warn(fmt, ...)  __ROWEN_LOG_NONE()
+  #define logger_kv_warn(msg, ...)   __ROWEN_LOG_NONE()
+#endif
+
+#if ROWEN_LOG_MIN_LEVEL >= 4
+  #define logger_info(fmt, ...)      __ROWEN_LOG(rs::Logger::Level::INFO, fmt, ##__VA_ARGS__)
+  #define logger_bin_info(fmt, ...)  __ROWEN_LOG_BIN(rs::Logger::Level::INFO, fmt, ##__VA_ARGS__)
+  #define logger_fmt_info(fmt, ...)  __ROWEN_LOG_FMT(rs::Logger::Level::INFO, fmt, ##__VA_ARGS__)
+  #define logger_kv_info(msg, ...)   __ROWEN_LOG_KV(rs::Logger::Level::INFO, msg, __VA_ARGS__)
+#else
+  #define logger_info(fmt, ...)      __ROWEN_LOG_NONE()
+  #define logger_bin_info(fmt, ...)  __ROWEN_LOG_NONE()
+  #define logger_fmt_info(fmt, ...)  __ROWEN_LOG_NONE()
+  #define logger_kv_info(msg, ...)   __ROWEN_LOG_NONE()
+#endif
+
+#if ROWEN_LOG_MIN_LEVEL >= 5
+  #define logger_debug(fmt, ...)     __ROWEN_LOG(rs::Logger::Level::DEBUG, fmt, ##__VA_ARGS__)
+  #define logger_bin_debug(fmt, ...) __ROWEN_LOG_BIN(rs::Logger::Level::DEBUG, fmt, ##__VA_ARGS__)
+  #define logger_fmt_debug(fmt, ...) __ROWEN_LOG_FMT(rs::Logger::Level::DEBUG, fmt, ##__VA_ARGS__)
+  #define logger_kv_debug(msg, ...)  __ROWEN_LOG_KV(rs::Logger::Level::DEBUG, msg, __VA_ARGS__)
+#else
+  #define logger_debug(fmt, ...)     __ROWEN_LOG_NONE()
+  #define logger_bin_debug(fmt, ...) __ROWEN_LOG_NONE()
+  #define logger_fmt_debug(fmt, ...) __ROWEN_LOG_NONE()
+  #define logger_kv_debug(msg, ...)  __ROWEN_LOG_NONE()
+#endif
+
+#if ROWEN_LOG_MIN_LEVEL >= 6
+  #define logger_trace(fmt, ...)     __ROWEN_LOG(rs::Logger::Level::TRACE, fmt, ##__VA_ARGS__)
+  #define logger_bin_trace(fmt, ...) __ROWEN_LOG_BIN(rs::Logger::Level::TRACE, fmt, ##__VA_ARGS__)
+  #define logger_fmt_trace(fmt, ...) __ROWEN_LOG_FMT(rs::Logger::Level::TRACE, fmt, ##__VA_ARGS__)
+  #define logger_kv_trace(msg, ...)  __ROWEN_LOG_KV(rs::Logger::Level::TRACE, msg, __VA_ARGS__)
+#else
+  #define logger_trace(fmt, ...)     __ROWEN_LOG_NONE()
+  #define logger_bin_trace(fmt, ...) __ROWEN_LOG_NONE()
+  #define logger_fmt_trace(fmt, ...) __ROWEN_LOG_NONE()
+  #define logger_kv_trace(msg, ...)  __ROWEN_LOG_NONE()
+#endif
 
 #define logger_errno(_TITLE_, _STR_)	{ logger.error("%s : %s (%d, %s)", _TITLE_, _STR_, errno, strerror(errno)); }
 // clang-format on
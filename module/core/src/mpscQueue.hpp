@@ -0,0 +1,113 @@
+#ifndef __ROWEN_SDK_CORE_MPSCQUEUE_HPP__
+#define __ROWEN_SDK_CORE_MPSCQUEUE_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace rs {
+
+// Bounded lock-free multi-producer / single-consumer queue.
+// Slots are constructed once and reused, so the payload keeps its capacity.
+template <typename T>
+class MPSCQueue {
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T                   data;
+  };
+
+ public:
+  explicit MPSCQueue(size_t capacity)
+  {
+    // round up to power of 2
+    capacity_ = 2;
+    while (capacity_ < capacity)
+      capacity_ <<= 1;
+    mask_ = capacity_ - 1;
+
+    cells_ = std::make_unique<Cell[]>(capacity_);
+    for (size_t i = 0; i < capacity_; ++i)
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  MPSCQueue(const MPSCQueue&)            = delete;
+  MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+  // fill(T&) is called on the reserved slot, returns false if queue is full
+  // (the slot is published even if fill throws, the consumer would stall)
+  template <typename Callable>
+  bool tryPush(Callable&& fill)
+  {
+    Cell*  cell;
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+
+    while (true) {
+      cell     = &cells_[pos & mask_];
+      auto seq = cell->sequence.load(std::memory_order_acquire);
+      auto dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+      if (dif == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed))
+          break;
+      }
+      else if (dif < 0) {
+        return false;  // full
+      }
+      else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+
+    struct Publish {
+      std::atomic<size_t>& sequence;
+      size_t               value;
+      ~Publish() { sequence.store(value, std::memory_order_release); }
+    } publish = { cell->sequence, pos + 1 };
+
+    fill(cell->data);
+    return true;
+  }
+
+  // consume(T&) is called on the oldest slot, returns false if queue is empty
+  // (single consumer only)
+  template <typename Callable>
+  bool tryPop(Callable&& consume)
+  {
+    size_t pos  = dequeue_pos_.load(std::memory_order_relaxed);
+    Cell*  cell = &cells_[pos & mask_];
+    auto   seq  = cell->sequence.load(std::memory_order_acquire);
+
+    if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0)
+      return false;  // empty
+
+    consume(cell->data);
+    dequeue_pos_.store(pos + 1, std::memory_order_relaxed);
+    cell->sequence.store(pos + capacity_, std::memory_order_release);
+    return true;
+  }
+
+  // approximate count of queued items
+  size_t size() const
+  {
+    auto enq = enqueue_pos_.load(std::memory_order_relaxed);
+    auto deq = dequeue_pos_.load(std::memory_order_relaxed);
+    return (enq > deq) ? (enq - deq) : 0;
+  }
+
+  bool   empty() const { return size() == 0; }
+  size_t capacity() const { return capacity_; }
+
+ private:
+  std::unique_ptr<Cell[]> cells_;
+  size_t                  capacity_;
+  size_t                  mask_;
+
+  alignas(64) std::atomic<size_t> enqueue_pos_ = { 0 };
+  alignas(64) std::atomic<size_t> dequeue_pos_ = { 0 };
+};
+
+}  // namespace rs
+
+#endif  //__ROWEN_SDK_CORE_MPSCQUEUE_HPP__
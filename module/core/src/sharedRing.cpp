@@ -0,0 +1,352 @@
+#include "sharedRing.hpp"
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <signal.h>
+  #include <sys/file.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+
+namespace rs {
+
+static const uint32_t SHARED_RING_MAGIC   = 0x52534C47;  // "RSLG"
+static const uint32_t SHARED_RING_VERSION = 3;
+
+// a reserved slot not claimed within this time is skipped (dead producer),
+// a claimed slot is skipped only when its producer has exited
+static const int64_t SHARED_RING_STALL_MS = 2000;
+
+// claimed slot : WRITING | producer pid << 32 | low 32 bits of the ticket
+static const uint64_t SHARED_RING_WRITING = 1ull << 63;
+
+struct SharedRing::Header {
+  uint32_t              magic;
+  uint32_t              version;
+  uint64_t              capacity;   // slots (power of 2)
+  uint64_t              slot_size;  // bytes of a slot
+  std::atomic<uint32_t> ready;
+  std::atomic<int32_t>  consumer;  // pid of the collector (0 : none)
+
+  alignas(64) std::atomic<uint64_t> head;  // next ticket (producers)
+  alignas(64) std::atomic<uint64_t> tail;  // next ticket (collector)
+};
+
+// sequence : ticket (free), claimed (copying), ticket + 1 (published)
+struct SharedRing::Slot {
+  std::atomic<uint64_t> sequence;
+  Entry                 entry;
+  // text follows
+};
+
+static size_t alignUp(size_t size, size_t alignment)
+{
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+// bytes before the first slot (Header, cache line aligned)
+static const size_t SHARED_RING_HEADER_SIZE = 256;
+
+static uint64_t claimedSequence(uint64_t ticket, uint32_t pid)
+{
+  return SHARED_RING_WRITING | (static_cast<uint64_t>(pid & 0x7FFFFFFF) << 32) |
+         (ticket & 0xFFFFFFFF);
+}
+
+static bool isClaimed(uint64_t sequence, uint64_t ticket)
+{
+  return (sequence & SHARED_RING_WRITING) &&
+         (sequence & 0xFFFFFFFF) == (ticket & 0xFFFFFFFF);
+}
+
+static int64_t nowMs()
+{
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+SharedRing::~SharedRing()
+{
+  close();
+}
+
+bool SharedRing::open(const std::string& name, size_t capacity,
+                      size_t record_size)
+{
+  close();
+#ifdef _WIN32
+  (void)name;
+  (void)capacity;
+  (void)record_size;
+  return false;  // POSIX shared memory only
+#else
+  static_assert(sizeof(Header) <= SHARED_RING_HEADER_SIZE,
+                "shared ring header size");
+
+  size_t slots = 1;
+  while (slots < capacity)
+    slots <<= 1;
+
+  int fd = shm_open(name.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0666);
+  if (fd < 0)
+    return false;
+
+  // (cross-process lock at creation only)
+  flock(fd, LOCK_EX);
+
+  struct stat st;
+  void*       memory = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && st.st_size == 0) {
+    // creator : size & initialize the ring
+    size_t slot_size = alignUp(sizeof(Slot) + record_size, 64);
+    size_t size      = SHARED_RING_HEADER_SIZE + slots * slot_size;
+    if (ftruncate(fd, static_cast<off_t>(size)) == 0)
+      memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    if (memory != MAP_FAILED) {
+      header_            = new (memory) Header();
+      size_              = size;
+      header_->magic     = SHARED_RING_MAGIC;
+      header_->version   = SHARED_RING_VERSION;
+      header_->capacity  = slots;
+      header_->slot_size = slot_size;
+      header_->consumer.store(0);
+      header_->head.store(0);
+      header_->tail.store(0);
+      for (uint64_t i = 0; i < slots; ++i) {
+        auto target = new (slot(i)) Slot();
+        target->sequence.store(i, std::memory_order_relaxed);
+      }
+      header_->ready.store(1, std::memory_order_release);
+    }
+  }
+  else if (static_cast<size_t>(st.st_size) >= SHARED_RING_HEADER_SIZE) {
+    // attach : the creator's geometry is used
+    size_t size = static_cast<size_t>(st.st_size);
+    memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (memory != MAP_FAILED) {
+      header_ = static_cast<Header*>(memory);
+      size_   = size;
+      if (header_->magic != SHARED_RING_MAGIC ||
+          header_->version != SHARED_RING_VERSION ||
+          header_->ready.load(std::memory_order_acquire) == 0)
+        close();
+    }
+  }
+
+  flock(fd, LOCK_UN);
+  ::close(fd);
+  return header_ != nullptr;
+#endif
+}
+
+void SharedRing::close()
+{
+#ifndef _WIN32
+  if (header_)
+    munmap(header_, size_);
+#endif
+  header_  = nullptr;
+  size_    = 0;
+  pending_ = UINT64_MAX;
+}
+
+size_t SharedRing::recordSize() const
+{
+  return header_ ? header_->slot_size - sizeof(Slot) : 0;
+}
+
+SharedRing::Slot* SharedRing::slot(uint64_t ticket) const
+{
+  auto index = ticket & (header_->capacity - 1);
+  return reinterpret_cast<Slot*>(reinterpret_cast<char*>(header_) +
+                                 SHARED_RING_HEADER_SIZE +
+                                 index * header_->slot_size);
+}
+
+bool SharedRing::push(const Entry& entry, const char* text,
+                      const char* fields, const char* file)
+{
+  if (header_ == nullptr)
+    return false;
+
+  // reserve a ticket (bounded MPMC ring)
+  auto  ticket = header_->head.load(std::memory_order_relaxed);
+  Slot* target = nullptr;
+  while (true) {
+    target        = slot(ticket);
+    auto sequence = target->sequence.load(std::memory_order_acquire);
+    auto diff     = static_cast<int64_t>(sequence - ticket);
+    if (sequence & SHARED_RING_WRITING) {
+      return false;  // full (previous round is still being copied)
+    }
+    else if (diff == 0) {
+      if (header_->head.compare_exchange_weak(ticket, ticket + 1,
+                                              std::memory_order_relaxed))
+        break;
+    }
+    else if (diff < 0) {
+      return false;  // full
+    }
+    else {
+      ticket = header_->head.load(std::memory_order_relaxed);
+    }
+  }
+
+  // claim before copying : fails if the collector skipped the slot as
+  // stalled meanwhile (it may already belong to the next round)
+  auto expected = ticket;
+#ifdef _WIN32
+  const uint32_t pid = 0;
+#else
+  const uint32_t pid = static_cast<uint32_t>(getpid());
+#endif
+  if (target->sequence.compare_exchange_strong(expected,
+                                               claimedSequence(ticket, pid),
+                                               std::memory_order_acquire) ==
+      false)
+    return false;
+
+  // fields & file (NUL terminated) after the text, dropped if they take more
+  // than half of the slot
+  size_t fields_length = fields ? entry.fields_length : 0;
+  size_t file_length   = file ? entry.file_length : 0;
+  size_t extra = fields_length + (file_length > 0 ? file_length + 1 : 0);
+  if (extra > recordSize() / 2) {
+    fields_length = file_length = 0;
+    extra                       = 0;
+  }
+
+  // (truncated text keeps its line feed)
+  auto data   = reinterpret_cast<char*>(target + 1);
+  auto length = std::min<size_t>(entry.length, recordSize() - extra);
+  memcpy(data, text, length);
+  if (length < entry.length && length > 0)
+    data[length - 1] = '\n';
+  memcpy(data + length, fields, fields_length);
+  if (file_length > 0) {
+    memcpy(data + length + fields_length, file, file_length);
+    data[length + fields_length + file_length] = '\0';
+  }
+  target->entry               = entry;
+  target->entry.length        = static_cast<uint32_t>(length);
+  target->entry.fields_length = static_cast<uint32_t>(fields_length);
+  target->entry.file_length   = static_cast<uint32_t>(file_length);
+
+  // publish (a claimed slot is never skipped while this process lives)
+  target->sequence.store(ticket + 1, std::memory_order_release);
+  return true;
+}
+
+bool SharedRing::pop(Entry& entry, const char*& text)
+{
+  if (header_ == nullptr)
+    return false;
+
+  // release the slot of the previous record (its text is read by now)
+  if (pending_ != UINT64_MAX) {
+    slot(pending_)->sequence.store(pending_ + header_->capacity,
+                                   std::memory_order_release);
+    pending_ = UINT64_MAX;
+  }
+
+  while (true) {
+    auto  ticket   = header_->tail.load(std::memory_order_relaxed);
+    Slot* target   = slot(ticket);
+    auto  sequence = target->sequence.load(std::memory_order_acquire);
+
+    if (sequence == ticket + 1) {
+      entry = target->entry;
+      text  = reinterpret_cast<const char*>(target + 1);
+
+      // the slot is released on the next call
+      pending_ = ticket;
+      header_->tail.store(ticket + 1, std::memory_order_relaxed);
+      stalled_ticket_ = UINT64_MAX;
+      return true;
+    }
+
+    // empty, or reserved and not published yet
+    if (header_->head.load(std::memory_order_relaxed) == ticket)
+      return false;
+
+    auto now = nowMs();
+    if (stalled_ticket_ != ticket) {
+      stalled_ticket_ = ticket;
+      stalled_since_  = now;
+      return false;
+    }
+    if (now - stalled_since_ < SHARED_RING_STALL_MS)
+      return false;
+
+    // claimed : the producer is copying unless it has exited (a slow or
+    // stopped producer is waited for, its copy would land in a reused slot)
+    if (isClaimed(sequence, ticket)) {
+#ifndef _WIN32
+      auto pid = static_cast<pid_t>((sequence >> 32) & 0x7FFFFFFF);
+      if (kill(pid, 0) == 0 || errno != ESRCH)
+        return false;
+#endif
+    }
+
+    // producer died : skip the slot (unless just claimed or published, a
+    // late producer fails to claim it)
+    auto expected = sequence;
+    if (target->sequence.compare_exchange_strong(expected,
+                                                 ticket + header_->capacity))
+      header_->tail.store(ticket + 1, std::memory_order_relaxed);
+    stalled_ticket_ = UINT64_MAX;
+  }
+}
+
+bool SharedRing::acquireConsumer()
+{
+#ifdef _WIN32
+  return false;
+#else
+  if (header_ == nullptr)
+    return false;
+
+  const int32_t pid   = static_cast<int32_t>(getpid());
+  int32_t       owner = header_->consumer.load();
+  while (true) {
+    if (owner == pid)
+      return true;
+    // another live collector
+    if (owner != 0 && (kill(owner, 0) == 0 || errno != ESRCH))
+      return false;
+    if (header_->consumer.compare_exchange_weak(owner, pid))
+      return true;
+  }
+#endif
+}
+
+void SharedRing::releaseConsumer()
+{
+#ifndef _WIN32
+  if (header_ == nullptr)
+    return;
+
+  int32_t pid = static_cast<int32_t>(getpid());
+  header_->consumer.compare_exchange_strong(pid, 0);
+#endif
+}
+
+void SharedRing::unlink(const std::string& name)
+{
+#ifndef _WIN32
+  shm_unlink(name.c_str());
+#else
+  (void)name;
+#endif
+}
+
+}  // namespace rs
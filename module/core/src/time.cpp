@@ -1,29 +1,235 @@
 #include "time.hpp"
 
+#if defined(__x86_64__) || defined(__i386__)
+  #include <cpuid.h>
+  #include <x86intrin.h>
+  #define ROWEN_TSC_X86
+#elif defined(_M_X64) || defined(_M_IX86)
+  #include <intrin.h>
+  #define ROWEN_TSC_X86
+#endif
+
+#ifndef _WIN32
+  #include <time.h>
+#endif
+
 #include <cmath>
+#include <mutex>
 
 using std::chrono::duration_cast;
 using std::chrono::hours;
+using std::chrono::steady_clock;
 using std::chrono::system_clock;
 
 namespace rs {
 
-std::unordered_map<std::string, Time::Tick> Time::elapsed_map_;
-std::unordered_map<std::string, Time::Tick> Time::interval_map_;
-Time::Resolution Time::current_time_resolution_ = Time::Resolution::MILLI;
+////////////////////////////////////////////////////////////////////////////////
+// Clock sources (nanoseconds)
+static uint64_t systemNanoseconds()
+{
+  return static_cast<uint64_t>(
+      duration_cast<nanoseconds>(system_clock::now().time_since_epoch())
+          .count());
+}
+
+static uint64_t steadyNanoseconds()
+{
+  return static_cast<uint64_t>(
+      duration_cast<nanoseconds>(steady_clock::now().time_since_epoch())
+          .count());
+}
+
+static uint64_t coarseNanoseconds()
+{
+#ifdef CLOCK_MONOTONIC_COARSE
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000 +
+         static_cast<uint64_t>(ts.tv_nsec);
+#else
+  return steadyNanoseconds();
+#endif
+}
+
+// CPU counter : cycles to steady clock nanoseconds (calibrated once)
+static uint64_t g_tsc_cycles     = 0;  // counter at calibration
+static uint64_t g_tsc_base       = 0;  // steady nanoseconds at calibration
+static uint64_t g_tsc_multiplier = 0;  // nanoseconds per cycle << 32
+
+static bool tscSupported()
+{
+#if defined(ROWEN_TSC_X86) && defined(_MSC_VER)
+  int registers[4];
+  __cpuid(registers, 0x80000000);
+  if (static_cast<unsigned>(registers[0]) < 0x80000007)
+    return false;
+  __cpuid(registers, 0x80000007);
+  return (registers[3] & (1 << 8)) != 0;  // invariant TSC
+#elif defined(ROWEN_TSC_X86)
+  unsigned int eax, ebx, ecx, edx;
+  if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) == 0)
+    return false;
+  return (edx & (1u << 8)) != 0;  // invariant TSC
+#elif defined(__aarch64__)
+  return true;  // generic timer (constant frequency)
+#else
+  return false;
+#endif
+}
+
+static inline uint64_t readCycles()
+{
+#if defined(ROWEN_TSC_X86)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  uint64_t value;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+  return value;
+#else
+  return 0;
+#endif
+}
+
+// (a * b) >> 32
+static inline uint64_t multiplyShift(uint64_t a, uint64_t b)
+{
+#ifdef _MSC_VER
+  uint64_t high;
+  uint64_t low = _umul128(a, b, &high);
+  return (high << 32) | (low >> 32);
+#else
+  return static_cast<uint64_t>((static_cast<unsigned __int128>(a) * b) >> 32);
+#endif
+}
+
+static uint64_t tscNanoseconds()
+{
+  return g_tsc_base + multiplyShift(readCycles() - g_tsc_cycles,
+                                    g_tsc_multiplier);
+}
+
+static bool calibrateTsc()
+{
+  static std::once_flag once;
+  static bool           calibrated = false;
+  std::call_once(once, [] {
+    if (tscSupported() == false)
+      return;
+
+    long double frequency;
+#if defined(__aarch64__)
+    uint64_t value;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(value));
+    frequency        = static_cast<long double>(value);
+    g_tsc_cycles     = readCycles();
+    g_tsc_base       = steadyNanoseconds();
+#else
+    // counter frequency measured against the steady clock (20 ms)
+    auto begin_ns    = steadyNanoseconds();
+    auto begin_cycle = readCycles();
+    std::this_thread::sleep_for(20ms);
+    g_tsc_base   = steadyNanoseconds();
+    g_tsc_cycles = readCycles();
+    frequency    = static_cast<long double>(g_tsc_cycles - begin_cycle) *
+                1e9L / static_cast<long double>(g_tsc_base - begin_ns);
+#endif
+    if (frequency < 1e6L)
+      return;
+
+    g_tsc_multiplier =
+        static_cast<uint64_t>(std::llround(1e9L * 4294967296.0L / frequency));
+    calibrated = true;
+  });
+  return calibrated;
+}
+
+// tick of a clock source in the resolution (divisor : nanoseconds per tick)
+template <uint64_t (*Source)(), uint64_t Divisor>
+static uint64_t readTick()
+{
+  return Source() / Divisor;
+}
 
 ////////////////////////////////////////////////////////////////////////////////
-// Options & Control
 
+std::unordered_map<std::string, Time::Tick> Time::interval_map_;
+
+// [clock][resolution] : constant initialized, never freed
 // clang-format off
-void Time::setResolution(Resolution resolution) { current_time_resolution_ = resolution; }
+const Time::TickSource Time::tick_sources_[4][4] = {
+  { { readTick<systemNanoseconds, 1000000000>, 1000000000, Clock::SYSTEM, Resolution::SEC   },
+    { readTick<systemNanoseconds, 1000000>,    1000000,    Clock::SYSTEM, Resolution::MILLI },
+    { readTick<systemNanoseconds, 1000>,       1000,       Clock::SYSTEM, Resolution::MICRO },
+    { readTick<systemNanoseconds, 1>,          1,          Clock::SYSTEM, Resolution::NANO  } },
+  { { readTick<steadyNanoseconds, 1000000000>, 1000000000, Clock::STEADY, Resolution::SEC   },
+    { readTick<steadyNanoseconds, 1000000>,    1000000,    Clock::STEADY, Resolution::MILLI },
+    { readTick<steadyNanoseconds, 1000>,       1000,       Clock::STEADY, Resolution::MICRO },
+    { readTick<steadyNanoseconds, 1>,          1,          Clock::STEADY, Resolution::NANO  } },
+  { { readTick<coarseNanoseconds, 1000000000>, 1000000000, Clock::COARSE, Resolution::SEC   },
+    { readTick<coarseNanoseconds, 1000000>,    1000000,    Clock::COARSE, Resolution::MILLI },
+    { readTick<coarseNanoseconds, 1000>,       1000,       Clock::COARSE, Resolution::MICRO },
+    { readTick<coarseNanoseconds, 1>,          1,          Clock::COARSE, Resolution::NANO  } },
+  { { readTick<tscNanoseconds, 1000000000>,    1000000000, Clock::TSC,    Resolution::SEC   },
+    { readTick<tscNanoseconds, 1000000>,       1000000,    Clock::TSC,    Resolution::MILLI },
+    { readTick<tscNanoseconds, 1000>,          1000,       Clock::TSC,    Resolution::MICRO },
+    { readTick<tscNanoseconds, 1>,             1,          Clock::TSC,    Resolution::NANO  } },
+};
 // clang-format on
 
+std::atomic<const Time::TickSource*> Time::tick_source_ = {
+  &Time::tick_sources_[0][1]  // SYSTEM, MILLI
+};
+
+// setClock vs setResolution (each keeps the other's current value)
+static std::mutex g_tick_source_mutex;
+
+////////////////////////////////////////////////////////////////////////////////
+// Options & Control
+
+
+void Time::setResolution(Resolution resolution)
+{
+  std::unique_lock<std::mutex> ulock(g_tick_source_mutex);
+  updateTickSource(clock(), resolution);
+}
+
+bool Time::setClock(Clock clock)
+{
+  bool available = true;
+  if (clock == Clock::TSC && calibrateTsc() == false) {
+    clock     = Clock::STEADY;
+    available = false;
+  }
+#ifndef CLOCK_MONOTONIC_COARSE
+  if (clock == Clock::COARSE) {
+    clock     = Clock::STEADY;
+    available = false;
+  }
+#endif
+
+  std::unique_lock<std::mutex> ulock(g_tick_source_mutex);
+  updateTickSource(clock, tick_source_.load()->resolution);
+  return available;
+}
+
+Time::Clock Time::clock()
+{
+  return tick_source_.load(std::memory_order_acquire)->clock;
+}
+
+// function, divisor & clock are published by one store
+void Time::updateTickSource(Clock clock, Resolution resolution)
+{
+  auto source = &tick_sources_[static_cast<int>(clock)]
+                              [static_cast<int>(resolution)];
+  tick_source_.store(source, std::memory_order_release);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 const char* Time::unit()
 {
-  switch (current_time_resolution_) {
+  switch (tick_source_.load(std::memory_order_acquire)->resolution) {
     case Resolution::SEC:
       return "sec";
     case Resolution::MILLI:
@@ -36,44 +242,58 @@ const char* Time::unit()
   return "null";
 }
 
-Time::Tick Time::tick()
-{
-  auto t = system_clock::now().time_since_epoch();
-  switch (current_time_resolution_) {
-    case Resolution::SEC:
-      return static_cast<Time::Tick>(duration_cast<seconds>(t).count());
-    case Resolution::MILLI:
-      return static_cast<Time::Tick>(duration_cast<milliseconds>(t).count());
-    case Resolution::MICRO:
-      return static_cast<Time::Tick>(duration_cast<microseconds>(t).count());
-    case Resolution::NANO:
-      return static_cast<Time::Tick>(duration_cast<nanoseconds>(t).count());
+// stopwatch keys (a slot is freed with its key & last handle)
+struct TimerRegistry {
+  using Slot = std::shared_ptr<std::atomic<uint64_t>>;
+
+  std::mutex                            mutex;
+  std::unordered_map<std::string, Slot> keys;
+
+  Slot find(const std::string& key, bool create)
+  {
+    std::unique_lock<std::mutex> ulock(mutex);
+    auto                         iter = keys.find(key);
+    if (iter != keys.end())
+      return iter->second;
+    if (create == false)
+      return nullptr;
+
+    auto slot = std::make_shared<std::atomic<uint64_t>>(UINT64_MAX);  // STOPPED
+    keys.emplace(key, slot);
+    return slot;
   }
-  return 0;
+
+  void erase(const std::string& key)
+  {
+    std::unique_lock<std::mutex> ulock(mutex);
+    keys.erase(key);
+  }
+};
+
+static TimerRegistry& timerRegistry()
+{
+  static TimerRegistry registry;
+  return registry;
 }
 
-void Time::setTimer(std::string key)
+Time::Timer Time::timer(const std::string& key)
 {
-  auto iter = elapsed_map_.find(key);
-  if (iter != elapsed_map_.end())
-    iter->second = tick();
-  else
-    elapsed_map_.insert({ key, tick() });
+  return Timer(timerRegistry().find(key, true));
 }
 
-void Time::removeTimer(std::string key)
+void Time::setTimer(const std::string& key)
 {
-  auto iter = elapsed_map_.find(key);
-  if (iter != elapsed_map_.end())
-    elapsed_map_.erase(iter);
+  timer(key).start();
 }
 
-Time::Tick Time::elapse(std::string key)
+void Time::removeTimer(const std::string& key)
 {
-  auto iter = elapsed_map_.find(key);
-  if (iter != elapsed_map_.end())
-    return (tick() - iter->second);
-  return 0;
+  timerRegistry().erase(key);
+}
+
+Time::Tick Time::elapse(const std::string& key)
+{
+  return Timer(timerRegistry().find(key, false)).elapse();
 }
 
 Time::Format Time::timeString(CFormat format, Tick tick, bool ext)
@@ -92,12 +312,25 @@ Time::Tick Time::casting(long double second)
   return static_cast<Time::Tick>(std::round(tickValue));
 }
 
+Time::Tick Time::toSystemTick(Tick tick, const TickSource& source)
+{
+  if (source.clock == Clock::SYSTEM)
+    return tick;
+
+  // monotonic tick : shifted by the current distance of the two clocks
+  auto system = systemNanoseconds() / source.nanoseconds;
+  return system - (source.function() - tick);
+}
+
 Time::Format Time::tickToString(Tick tick, bool ext, CFormat format)
 {
+  auto source = tick_source_.load(std::memory_order_acquire);
   if (tick == 0)
-    tick = Time::tick();
+    tick = systemNanoseconds() / source->nanoseconds;
+  else
+    tick = toSystemTick(tick, *source);
 
-  switch (current_time_resolution_) {
+  switch (source->resolution) {
     case Resolution::SEC:
       return _tickToString<seconds>(tick, ext, format);
     case Resolution::MILLI:
@@ -146,7 +379,7 @@ std::string Time::_tickToString(Tick tick, bool ext, CFormat format)
 
 long double Time::resolutionTick()
 {
-  switch (current_time_resolution_) {
+  switch (tick_source_.load(std::memory_order_acquire)->resolution) {
     case Resolution::SEC:
       return 1.0L;
     case Resolution::MILLI:
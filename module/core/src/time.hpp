@@ -1,8 +1,10 @@
 #ifndef __ROWEN_SDK_CORE_TIME_HPP__
 #define __ROWEN_SDK_CORE_TIME_HPP__
 
+#include <atomic>
 #include <chrono>
 #include <iomanip>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <thread>
@@ -30,34 +32,98 @@ class Time {
     NANO    // Nano second
   };
 
+  // tick source (ticks of different clocks are not comparable)
+  enum class Clock : int {
+    SYSTEM,  // wall clock, may jump with NTP (default)
+    STEADY,  // monotonic
+    COARSE,  // monotonic, updated every kernel tick (Linux, 1 ~ 4 ms)
+    TSC      // monotonic CPU counter (invariant TSC, cntvct_el0), calibrated
+             // on the steady clock at the first use
+  };
+
+  // Stopwatch handle : the key is looked up once (Time::timer), start &
+  // elapse are lock-free atomics usable from any thread (the slot is shared
+  // with the key until removeTimer, then owned by the handles left)
+  class Timer {
+   public:
+    Timer() = default;
+
+    void start()
+    {
+      if (slot_)
+        slot_->store(tick(), std::memory_order_relaxed);
+    }
+
+    // elapsed tick count since start (0 : not started or invalid handle)
+    Tick elapse() const
+    {
+      if (slot_ == nullptr)
+        return 0;
+      auto start = slot_->load(std::memory_order_relaxed);
+      return (start == STOPPED) ? 0 : tick() - start;
+    }
+
+    // back to the not started state
+    void stop()
+    {
+      if (slot_)
+        slot_->store(STOPPED, std::memory_order_relaxed);
+    }
+
+    bool isValid() const { return slot_ != nullptr; }
+
+   private:
+    friend class Time;
+    static constexpr Tick STOPPED = UINT64_MAX;
+
+    explicit Timer(std::shared_ptr<std::atomic<Tick>> slot)
+        : slot_(std::move(slot))
+    {
+    }
+
+    std::shared_ptr<std::atomic<Tick>> slot_;
+  };
+
  public:
   //////////////////////////
   // Options & Control
   static void setResolution(Resolution register_t = Resolution::MILLI);
+
+  // false : not available on this CPU or system (STEADY is used)
+  static bool  setClock(Clock clock);
+  static Clock clock();
   //////////////////////////
 
   // get time unit(ms, ns, us etc.)
   static const char* unit();
 
-  // get system tick count
-  static Tick tick();
+  // get tick count of the clock (no branch on the resolution)
+  static Tick tick()
+  {
+    return tick_source_.load(std::memory_order_acquire)->function();
+  }
+
+  // stopwatch handle of the key (created on the first call, kept until
+  // removeTimer)
+  static Timer timer(const std::string& key);
 
-  // set or update start time
-  static void setTimer(std::string key);
+  // set or update start time (key lookup : keep the handle in hot paths)
+  static void setTimer(const std::string& key);
 
-  // remove start time
-  static void removeTimer(std::string key);
+  // remove the key (handles of the key keep working, detached from it)
+  static void removeTimer(const std::string& key);
 
   // get elapsed tick count
-  static Tick elapse(std::string key);
+  static Tick elapse(const std::string& key);
 
   // check if the specified time has passed (boolean)
   template <typename __literals>
   static bool elapse(__literals target, Tick start, Tick end = 0)
   {
+    auto source = tick_source_.load(std::memory_order_acquire);
     if (end == 0)
-      end = tick();
-    return (end - start > literalToTick(target));
+      end = source->function();
+    return (end - start > literalToTick(target, *source));
   }
 
   // get time-string in the specified format
@@ -83,10 +149,11 @@ class Time {
   static void runInterval(literals interval, std::string key, callable&& func,
                           Args&&... args)
   {
-    auto time = tick();
-    auto iter = interval_map_.find(key);
+    auto source = tick_source_.load(std::memory_order_acquire);
+    auto time   = source->function();
+    auto iter   = interval_map_.find(key);
     if (iter != interval_map_.end()) {
-      if (time - iter->second > literalToTick(interval)) {
+      if (time - iter->second > literalToTick(interval, *source)) {
         func(std::forward<args>(args)...);
         iter->second = time;
       }
@@ -103,6 +170,14 @@ class Time {
   }
 
  private:
+  // clock & resolution, published together (readers never mix the two)
+  struct TickSource {
+    Tick (*function)();
+    Tick       nanoseconds;  // nanoseconds per tick
+    Clock      clock;
+    Resolution resolution;
+  };
+
   // tick count to string
   static Format tickToString(Tick tick, bool ext, CFormat format);
 
@@ -127,27 +202,22 @@ class Time {
 
   // get adjust integer value (based on current resolution)
   template <typename literals>
-  static Tick literalToTick(literals time)
+  static Tick literalToTick(literals time, const TickSource& source)
   {
     using std::chrono::duration_cast;
-    switch (current_time_resolution_) {
-      case Resolution::SEC:
-        return duration_cast<seconds>(time).count();
-      case Resolution::MILLI:
-        return duration_cast<milliseconds>(time).count();
-      case Resolution::MICRO:
-        return duration_cast<microseconds>(time).count();
-      case Resolution::NANO:
-        return duration_cast<nanoseconds>(time).count();
-      default:
-        return UINT64_MAX;
-    }
+    return static_cast<Tick>(duration_cast<nanoseconds>(time).count()) /
+           source.nanoseconds;
   }
 
+  // tick of the clock to the system clock (time string)
+  static Tick toSystemTick(Tick tick, const TickSource& source);
+
+  static void updateTickSource(Clock clock, Resolution resolution);
+
  private:
-  static std::unordered_map<std::string, Tick> elapsed_map_;
   static std::unordered_map<std::string, Tick> interval_map_;
-  static Resolution                            current_time_resolution_;
+  static const TickSource                      tick_sources_[4][4];
+  static std::atomic<const TickSource*>        tick_source_;
 };
 
 };  // namespace rs
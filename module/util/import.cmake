@@ -9,3 +9,6 @@ make_directory(${__include_path}/${tag})
 # src
 setup(${CMAKE_CURRENT_LIST_DIR}/src/threadPool.hpp)
 setup(${CMAKE_CURRENT_LIST_DIR}/src/threadPool.cpp)
+
+setup(${CMAKE_CURRENT_LIST_DIR}/src/profiler.hpp)
+setup(${CMAKE_CURRENT_LIST_DIR}/src/profiler.cpp)
@@ -0,0 +1,560 @@
+#include "profiler.hpp"
+
+#ifdef _WIN32
+  #include <intrin.h>
+  #include <process.h>
+#else
+  #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "logFormat.hpp"
+#include "logger.hpp"
+
+namespace rs {
+
+static const int    MAX_DEPTH       = 64;
+static const int    SUB_BUCKET_BITS = 4;  // 16 sub-buckets : ~6% precision
+static const int    SUB_BUCKETS     = 1 << SUB_BUCKET_BITS;
+static const size_t BUCKETS         = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+static const uint32_t COLLECT_INTERVAL_MS = 50;
+
+namespace profiler {
+
+// zone completed on a thread
+struct Event {
+  uint32_t site;
+  uint32_t parent;  // enclosing zone (0 : none)
+  uint64_t start;
+  uint64_t duration;
+  uint64_t self;  // duration without the nested zones
+};
+
+// zone stack & event ring of a thread (single producer : the thread,
+// single consumer : the collector)
+struct ThreadData {
+  struct Frame {
+    uint32_t site;
+    uint64_t start;
+    uint64_t children;  // time of the nested zones
+  };
+
+  explicit ThreadData(uint32_t id, size_t capacity)
+      : id(id), capacity(capacity), events(std::make_unique<Event[]>(capacity))
+  {
+  }
+
+  Frame stack[MAX_DEPTH];
+  int   depth = 0;
+
+  uint32_t                 id;
+  size_t                   capacity;  // power of 2
+  std::unique_ptr<Event[]> events;
+  std::atomic<uint64_t>    head    = { 0 };  // written by the thread
+  std::atomic<uint64_t>    tail    = { 0 };  // written by the collector
+  std::atomic<uint64_t>    dropped = { 0 };
+  std::atomic<bool>        retired = { false };  // thread exited
+};
+
+}  // namespace profiler
+
+using profiler::Event;
+using profiler::ThreadData;
+
+// statistics of a zone under a parent zone
+struct ZoneStats {
+  uint64_t              count = 0;
+  uint64_t              total = 0;
+  uint64_t              self  = 0;
+  uint64_t              max   = 0;
+  std::vector<uint64_t> histogram = std::vector<uint64_t>(BUCKETS, 0);
+};
+
+struct TraceEvent {
+  uint32_t site;
+  uint32_t thread;
+  uint64_t start;
+  uint64_t duration;
+};
+
+struct ProfilerState {
+  std::mutex mutex;  // everything below (collector, reports & registration)
+
+  std::vector<Profiler::Site*>             sites;  // id - 1
+  std::vector<std::shared_ptr<ThreadData>> threads;
+  uint32_t                                 thread_count    = 0;
+  size_t                                   thread_capacity = 16384;
+  uint64_t                                 retired_dropped = 0;
+
+  std::unordered_map<uint64_t, ZoneStats> stats;  // (parent << 32) | site
+  uint64_t                                stats_since = Profiler::now();
+
+  std::vector<TraceEvent> trace;  // ring of the latest zones
+  uint64_t                trace_count = 0;
+
+  // collector thread
+  std::thread             collector;
+  std::condition_variable convar;
+  bool                    stop            = false;
+  uint32_t                report_interval = 0;
+  uint64_t                last_report     = 0;
+
+  ~ProfilerState();
+};
+
+static ProfilerState& state()
+{
+  static ProfilerState instance;
+  return instance;
+}
+
+// thread data : raw pointer for the zones, holder to retire it on exit
+struct ThreadHolder {
+  std::shared_ptr<ThreadData> data;
+  ~ThreadHolder()
+  {
+    if (data)
+      data->retired.store(true, std::memory_order_release);
+  }
+};
+
+static thread_local ThreadData*  g_thread_data = nullptr;
+static thread_local ThreadHolder g_thread_holder;
+
+static ThreadData* createThreadData()
+{
+  auto&                        state = rs::state();
+  std::unique_lock<std::mutex> ulock(state.mutex);
+
+  auto data = std::make_shared<ThreadData>(++state.thread_count,
+                                           state.thread_capacity);
+  state.threads.push_back(data);
+  g_thread_holder.data = data;
+  g_thread_data        = data.get();
+  return g_thread_data;
+}
+
+static uint32_t registerSite(Profiler::Site& site)
+{
+  auto&                        state = rs::state();
+  std::unique_lock<std::mutex> ulock(state.mutex);
+
+  auto id = site.id.load();
+  if (id == 0) {
+    state.sites.push_back(&site);
+    id = static_cast<uint32_t>(state.sites.size());
+    site.id.store(id);
+  }
+  return id;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Zone
+std::atomic<bool> Profiler::enabled_ = { false };
+
+void Profiler::Zone::begin(Site& site)
+{
+  auto data = g_thread_data ? g_thread_data : createThreadData();
+  if (data->depth >= MAX_DEPTH)
+    return;
+
+  auto id = site.id.load(std::memory_order_relaxed);
+  if (id == 0)
+    id = registerSite(site);
+
+  auto& frame    = data->stack[data->depth++];
+  frame.site     = id;
+  frame.children = 0;
+  thread_        = data;
+  frame.start    = now();
+}
+
+void Profiler::Zone::end()
+{
+  auto  end   = now();
+  auto  data  = thread_;
+  auto& frame = data->stack[--data->depth];
+
+  Event event;
+  event.site     = frame.site;
+  event.parent   = 0;
+  event.start    = frame.start;
+  event.duration = end - frame.start;
+  event.self     = event.duration - std::min(frame.children, event.duration);
+  if (data->depth > 0) {
+    auto& parent = data->stack[data->depth - 1];
+    parent.children += event.duration;
+    event.parent = parent.site;
+  }
+
+  auto head = data->head.load(std::memory_order_relaxed);
+  if (head - data->tail.load(std::memory_order_acquire) >= data->capacity) {
+    data->dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  data->events[head & (data->capacity - 1)] = event;
+  data->head.store(head + 1, std::memory_order_release);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Histogram (log-linear buckets, HDR style)
+static size_t bucketIndex(uint64_t value)
+{
+  if (value < static_cast<uint64_t>(SUB_BUCKETS))
+    return static_cast<size_t>(value);
+
+#ifdef _MSC_VER
+  unsigned long exponent;
+  _BitScanReverse64(&exponent, value);
+#else
+  int exponent = 63 - __builtin_clzll(value);
+#endif
+  auto sub = (value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+  return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS +
+         static_cast<size_t>(sub);
+}
+
+// middle of the bucket
+static uint64_t bucketValue(size_t index)
+{
+  if (index < static_cast<size_t>(SUB_BUCKETS))
+    return index;
+
+  int  exponent = static_cast<int>(index / SUB_BUCKETS) + SUB_BUCKET_BITS - 1;
+  auto sub      = static_cast<uint64_t>(index % SUB_BUCKETS);
+  auto width    = uint64_t(1) << (exponent - SUB_BUCKET_BITS);
+  return (SUB_BUCKETS + sub) * width + width / 2;
+}
+
+static uint64_t percentile(const ZoneStats& stats, double ratio)
+{
+  auto rank = static_cast<uint64_t>(ratio * stats.count + 0.5);
+  rank      = std::max<uint64_t>(rank, 1);
+
+  uint64_t count = 0;
+  for (size_t i = 0; i < BUCKETS; ++i) {
+    count += stats.histogram[i];
+    if (count >= rank)
+      return std::min(bucketValue(i), stats.max);
+  }
+  return stats.max;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Collector
+
+// move the thread rings into the statistics (state.mutex held)
+static void collect(ProfilerState& state)
+{
+  const auto trace_capacity = state.trace.size();
+
+  for (size_t i = 0; i < state.threads.size();) {
+    auto& data = *state.threads[i];
+
+    // (events pushed before the thread exited are visible)
+    bool retired = data.retired.load(std::memory_order_acquire);
+    auto tail    = data.tail.load(std::memory_order_relaxed);
+    auto head    = data.head.load(std::memory_order_acquire);
+    for (; tail < head; ++tail) {
+      const auto& event = data.events[tail & (data.capacity - 1)];
+
+      auto& stats = state.stats[(static_cast<uint64_t>(event.parent) << 32) |
+                                event.site];
+      stats.count++;
+      stats.total += event.duration;
+      stats.self += event.self;
+      stats.max = std::max(stats.max, event.duration);
+      stats.histogram[bucketIndex(event.duration)]++;
+
+      if (trace_capacity > 0) {
+        state.trace[state.trace_count++ % trace_capacity] = {
+          event.site, data.id, event.start, event.duration
+        };
+      }
+    }
+    data.tail.store(tail, std::memory_order_release);
+
+    if (retired) {
+      state.retired_dropped += data.dropped.load();
+      state.threads.erase(state.threads.begin() + i);
+    }
+    else {
+      ++i;
+    }
+  }
+}
+
+static void runCollector()
+{
+  auto&                        state = rs::state();
+  std::unique_lock<std::mutex> ulock(state.mutex);
+  while (state.stop == false) {
+    state.convar.wait_for(ulock,
+                          std::chrono::milliseconds(COLLECT_INTERVAL_MS));
+    collect(state);
+
+    auto now = Profiler::now();
+    if (state.report_interval > 0 &&
+        now - state.last_report >= state.report_interval * 1000000ull) {
+      state.last_report = now;
+      if (state.stats.empty())
+        continue;
+
+      // logged without the lock (zones & collection continue)
+      ulock.unlock();
+      Profiler::report(true);
+      ulock.lock();
+    }
+  }
+  collect(state);
+}
+
+ProfilerState::~ProfilerState()
+{
+  {
+    std::unique_lock<std::mutex> ulock(mutex);
+    stop = true;
+  }
+  convar.notify_all();
+  if (collector.joinable())
+    collector.join();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Options & Control
+void Profiler::setEnabled(bool enable)
+{
+  auto&                        state = rs::state();
+  std::unique_lock<std::mutex> ulock(state.mutex);
+  enabled_.store(enable);
+
+  if (enable && state.collector.joinable() == false) {
+    state.stop        = false;
+    state.last_report = now();
+    state.collector   = std::thread(runCollector);
+  }
+  else if (enable == false && state.collector.joinable()) {
+    state.stop = true;
+    state.convar.notify_all();
+    ulock.unlock();
+    state.collector.join();
+  }
+}
+
+void Profiler::setReportInterval(uint32_t interval_ms)
+{
+  auto&                        state = rs::state();
+  std::unique_lock<std::mutex> ulock(state.mutex);
+  state.report_interval = interval_ms;
+  state.last_report     = now();
+}
+
+void Profiler::setTraceCapacity(size_t events)
+{
+  auto&                        state = rs::state();
+  std::unique_lock<std::mutex> ulock(state.mutex);
+  state.trace.assign(events, TraceEvent{});
+  state.trace_count = 0;
+}
+
+void Profiler::setThreadCapacity(size_t events)
+{
+  size_t capacity = 2;
+  while (capacity < events)
+    capacity <<= 1;
+
+  auto&                        state = rs::state();
+  std::unique_lock<std::mutex> ulock(state.mutex);
+  state.thread_capacity = capacity;
+}
+
+void Profiler::reset()
+{
+  auto&                        state = rs::state();
+  std::unique_lock<std::mutex> ulock(state.mutex);
+  collect(state);
+  state.stats.clear();
+  state.stats_since = now();
+  state.trace_count = 0;
+}
+
+uint64_t Profiler::dropped()
+{
+  auto&                        state = rs::state();
+  std::unique_lock<std::mutex> ulock(state.mutex);
+
+  uint64_t dropped = state.retired_dropped;
+  for (auto& data : state.threads)
+    dropped += data->dropped.load();
+  return dropped;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Reports
+
+// "850ns", "12.3us", "4.56ms", "1.23s"
+static void appendDuration(FormatBuffer& buffer, uint64_t ns)
+{
+  char text[32];
+  if (ns < 1000)
+    snprintf(text, sizeof(text), "%lluns", static_cast<unsigned long long>(ns));
+  else if (ns < 1000000)
+    snprintf(text, sizeof(text), "%.3gus", ns / 1e3);
+  else if (ns < 1000000000)
+    snprintf(text, sizeof(text), "%.3gms", ns / 1e6);
+  else
+    snprintf(text, sizeof(text), "%.3gs", ns / 1e9);
+  buffer.printf("%10s", text);
+}
+
+// zone tree : children of `parent` (sorted by total time), depth first
+static void appendZones(FormatBuffer& buffer, const ProfilerState& state,
+                        const std::unordered_map<uint32_t,
+                                                 std::vector<uint64_t>>& tree,
+                        uint32_t parent, int depth,
+                        std::vector<uint32_t>& path)
+{
+  auto children = tree.find(parent);
+  if (children == tree.end())
+    return;
+
+  for (auto key : children->second) {
+    auto        site  = static_cast<uint32_t>(key & 0xFFFFFFFF);
+    const auto& stats = state.stats.at(key);
+    const char* name  = state.sites[site - 1]->name;
+
+    buffer.printf("%*s%-*s %9llu", depth * 2, "", 32 - depth * 2, name,
+                  static_cast<unsigned long long>(stats.count));
+    appendDuration(buffer, stats.total / stats.count);
+    appendDuration(buffer, percentile(stats, 0.50));
+    appendDuration(buffer, percentile(stats, 0.99));
+    appendDuration(buffer, stats.max);
+    appendDuration(buffer, stats.total);
+    appendDuration(buffer, stats.self);
+    buffer.append('\n');
+
+    // (recursive zones are shown once per path)
+    if (std::find(path.begin(), path.end(), site) == path.end() &&
+        depth < 16) {
+      path.push_back(site);
+      appendZones(buffer, state, tree, site, depth + 1, path);
+      path.pop_back();
+    }
+  }
+}
+
+std::string Profiler::reportText(bool reset)
+{
+  auto&                        state = rs::state();
+  std::unique_lock<std::mutex> ulock(state.mutex);
+  collect(state);
+
+  std::unordered_map<uint32_t, std::vector<uint64_t>> tree;
+  for (auto& stats : state.stats)
+    tree[static_cast<uint32_t>(stats.first >> 32)].push_back(stats.first);
+  for (auto& children : tree) {
+    std::sort(children.second.begin(), children.second.end(),
+              [&state](uint64_t a, uint64_t b) {
+                return state.stats.at(a).total > state.stats.at(b).total;
+              });
+  }
+
+  uint64_t dropped = state.retired_dropped;
+  for (auto& data : state.threads)
+    dropped += data->dropped.load();
+
+  FormatBuffer buffer;
+  buffer.printf("profile : %.3fs, %zu threads, %llu dropped\n",
+                (now() - state.stats_since) / 1e9, state.threads.size(),
+                static_cast<unsigned long long>(dropped));
+  buffer.printf("%-32s %9s%10s%10s%10s%10s%10s%10s\n", "zone", "count", "mean",
+                "p50", "p99", "max", "total", "self");
+
+  std::vector<uint32_t> path;
+  appendZones(buffer, state, tree, 0, 0, path);
+
+  // zones nested in a zone still running (not completed yet)
+  for (auto& children : tree) {
+    auto parent = children.first;
+    bool open   = parent != 0;
+    for (auto& stats : state.stats) {
+      if (static_cast<uint32_t>(stats.first & 0xFFFFFFFF) == parent) {
+        open = false;
+        break;
+      }
+    }
+    if (open) {
+      buffer.printf("%s (running)\n", state.sites[parent - 1]->name);
+      path.push_back(parent);
+      appendZones(buffer, state, tree, parent, 1, path);
+      path.pop_back();
+    }
+  }
+
+  if (reset) {
+    state.stats.clear();
+    state.stats_since = now();
+  }
+  return std::string(buffer.data(), buffer.size());
+}
+
+void Profiler::report(bool reset)
+{
+  auto text = reportText(reset);
+  if (text.empty() == false && text.back() == '\n')
+    text.pop_back();
+  Logger::info("%s", text.c_str());
+}
+
+bool Profiler::writeChromeTrace(const std::string& path)
+{
+  auto&                        state = rs::state();
+  std::unique_lock<std::mutex> ulock(state.mutex);
+  collect(state);
+
+  FILE* file = fopen(path.c_str(), "wb");
+  if (file == nullptr)
+    return false;
+
+#ifdef _WIN32
+  const int pid = _getpid();
+#else
+  const int pid = static_cast<int>(getpid());
+#endif
+
+  // oldest first
+  auto capacity = state.trace.size();
+  auto count    = std::min<uint64_t>(state.trace_count, capacity);
+  auto first    = state.trace_count - count;
+
+  FormatBuffer buffer;
+  buffer.append("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", 40);
+  for (uint64_t i = 0; i < count; ++i) {
+    const auto& event = state.trace[(first + i) % capacity];
+    buffer.append(i > 0 ? ",\n{\"name\":" : "{\"name\":", i > 0 ? 10 : 8);
+    formatter::appendJsonString(buffer, state.sites[event.site - 1]->name);
+    buffer.printf(",\"cat\":\"zone\",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,"
+                  "\"ts\":%.3f,\"dur\":%.3f}",
+                  pid, event.thread, event.start / 1e3, event.duration / 1e3);
+
+    if (buffer.size() > FormatBuffer::FIXED_SIZE / 2) {
+      fwrite(buffer.data(), 1, buffer.size(), file);
+      buffer.clear();
+    }
+  }
+  buffer.append("\n]}\n", 4);
+  fwrite(buffer.data(), 1, buffer.size(), file);
+
+  return fclose(file) == 0;
+}
+
+}  // namespace rs
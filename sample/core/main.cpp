@@ -2,6 +2,19 @@
 
 #include "rowen/core.hpp"
 
+// class or method name inside a generic lambda of a class template
+template <typename T>
+struct Sample {
+  void run(T value)
+  {
+    auto print = [](auto v) {
+      logger.info("%s %s : value %d", __CLASS__, __METHOD__,
+                  static_cast<int>(v));
+    };
+    print(value);
+  }
+};
+
 int main()
 {
   std::string str;
@@ -35,12 +48,53 @@ int main()
   rs::Logger::info("this is log %d", 2);  // also same above
   logger_info("this is log %d", 3);       // include file & line
 
+  // type-safe format (checked at compile-time, no printf)
+  logger.info(RS_FMT("this is log {} ({})"), 4, "fmt");
+  logger_fmt_info("this is log {} ({})", 5, 1.5);  // include file & line
+
+  // structured fields (JSON lines or logfmt per sink : LogSink::setFormat)
+  logger.info("request done", rs::kv("latency_us", 120), rs::kv("id", "a1"));
+
+  // asynchronous mode (file & console output on a writer thread)
+  rs::Logger::setAsyncLogging(true);
+  logger.info("this is async log");
+  rs::Logger::flush();  // wait until written
+  rs::Logger::setAsyncLogging(false);
+
+  // binary mode (decode YYYY_MM_DD-HH-NN.bin files with log_decoder)
+  rs::Logger::setBinaryLogging(true);
+  logger_bin_info("this is binary log %d %s %.3f", 4, "text", 1.5);
+  rs::Logger::setBinaryLogging(false);
+
+  // named logger (own directory ./log/network, options & writer thread)
+  auto& network = rs::Logger::get("network");
+  network.setLevel(rs::Logger::Level::DEBUG);
+  network.debug("this is network log %d", 5);
+
+  // additional sink (keep the latest records in memory)
+  auto ring = std::make_shared<rs::RingSink>(16);
+  ring->setLevel(rs::Logger::Level::TRACE);
+  rs::Logger::addSink("ring", ring);
+  logger.info("this is log kept in the ring sink");
+  for (auto& record : ring->snapshot())
+    std::cout << "ring : " << record;
+  rs::Logger::removeSink("ring");
+
+  // log storm protection (per logger_* call-site)
+  rs::Logger::setThrottle(rs::LogThrottle::Mode::TOKEN_BUCKET, 10, 5);
+  rs::Logger::setRepeatSuppression(1000);
+  for (int i = 0; i < 100; ++i)
+    logger_warn("this is repeated log");
+  rs::Logger::setThrottle(rs::LogThrottle::Mode::NONE);
+  rs::Logger::setRepeatSuppression(0);
+
   // trace log is not visible in console, only in the file
   logger.trace("this is trace log");
 
   // parsing class or current function's name
   logger.info("%s : this is class", __CLASS__);
   logger.info("%s : this is method", __METHOD__);
+  Sample<int>().run(1);
 
   ////////////////////////////////////////////////////////////////////////////
   // Time
@@ -51,6 +105,9 @@ int main()
   Time::setResolution(Time::Resolution::MICRO);  // or
   Time::setResolution(Time::Resolution::NANO);
 
+  // monotonic tick source (default SYSTEM : wall clock)
+  Time::setClock(Time::Clock::STEADY);  // or COARSE, TSC
+
   // ex 1. Get tick count
   auto tick = Time::tick();
 
@@ -60,11 +117,16 @@ int main()
 
   Time::sleep(1s);
   auto elapsed1 = Time::elapse("my-stop watch-1");
-  logger.info("elapsed 1 : %lu %s", elapsed1, Time::unit());
+  logger.info(RS_FMT("elapsed 1 : {} {}"), elapsed1, Time::unit());
 
   Time::sleep(2s);
   auto elapsed2 = Time::elapse("my-stop watch-2");
-  logger.info("elapsed 2 : %lu %s", elapsed2, Time::unit());
+  logger.info(RS_FMT("elapsed 2 : {} {}"), elapsed2, Time::unit());
+
+  // handle : key interned once, start & elapse are lock-free (any thread)
+  auto watch = Time::timer("my-stop watch-3");
+  watch.start();
+  logger.info(RS_FMT("elapsed 3 : {} {}"), watch.elapse(), Time::unit());
 
   // ex 3. Time string
   auto tick_time_string     = Time::timeString(tick);
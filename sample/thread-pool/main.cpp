@@ -11,10 +11,10 @@ void printThreadInfo(rs::ThreadPool* pool)
   if (pool == nullptr)
     return;
 
-  logger.info("Working Threads: %lu"
-              ", Waiting Jobs: %lu"
-              ", Total Threads: %lu"
-              ", Maximum Threads: %lu",
+  logger.info(RS_FMT("Working Threads: {}"
+                     ", Waiting Jobs: {}"
+                     ", Total Threads: {}"
+                     ", Maximum Threads: {}"),
               pool->workingCount(), pool->waitingCount(), pool->workerCount(),
               pool->maxThreads());
 }
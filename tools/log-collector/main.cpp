@@ -0,0 +1,61 @@
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include "rowen/core.hpp"
+
+static volatile std::sig_atomic_t g_stop = 0;
+
+static void onSignal(int)
+{
+  g_stop = 1;
+}
+
+int main(int argc, char** argv)
+{
+  const char* directory = "./log/";
+  const char* name      = "/rowen-log";
+  size_t      limit     = 0;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      name = argv[++i];
+      continue;
+    }
+    if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+      limit = strtoull(argv[++i], nullptr, 10);
+      continue;
+    }
+    if (argv[i][0] == '-') {
+      printf("usage : %s [-n name] [-s bytes] [directory]\n", argv[0]);
+      printf("  -n : shared memory name (default /rowen-log)\n");
+      printf("  -s : rotate log files over the size (default unlimited)\n");
+      printf("  directory : output directory (default ./log/)\n");
+      return 1;
+    }
+    directory = argv[i];
+  }
+
+  rs::LogCollector collector(name);
+  collector.file().setSizeLimit(limit);
+  if (collector.start(directory) == false) {
+    fprintf(stderr, "cannot collect %s (not opened or collected by another "
+                    "process)\n", name);
+    return 1;
+  }
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  printf("collecting %s into %s\n", name, directory);
+
+  while (g_stop == 0)
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  collector.stop();
+  printf("collected %llu records\n",
+         static_cast<unsigned long long>(collector.collected()));
+  return 0;
+}
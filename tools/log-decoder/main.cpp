@@ -0,0 +1,389 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "rowen/core.hpp"
+
+using rs::binlog::Arg;
+using rs::binlog::Kind;
+
+struct Format {
+  int         level = 0;
+  int         line  = 0;
+  std::string fmt;
+  std::string file;
+};
+
+struct Value {
+  Arg         type = Arg::I64;
+  int64_t     i    = 0;
+  uint64_t    u    = 0;
+  double      f    = 0;
+  std::string str;
+};
+
+static const char* keyword(int level)
+{
+  switch (static_cast<rs::Logger::Level>(level)) {
+    case rs::Logger::Level::FATAL:
+      return "[FATAL]";
+    case rs::Logger::Level::ERROR:
+      return "[ERROR]";
+    case rs::Logger::Level::WARN:
+      return "[WARN]";
+    case rs::Logger::Level::INFO:
+      return "[INFO]";
+    case rs::Logger::Level::DEBUG:
+      return "[DEBUG]";
+    case rs::Logger::Level::TRACE:
+      return "[TRACE]";
+    default:
+      return "";
+  }
+}
+
+// clang-format off
+static long long asSigned(const Value& v)
+{
+  switch (v.type) {
+    case Arg::I32: case Arg::I64: return static_cast<long long>(v.i);
+    case Arg::F64:                return static_cast<long long>(v.f);
+    default:                      return static_cast<long long>(v.u);
+  }
+}
+
+static unsigned long long asUnsigned(const Value& v)
+{
+  switch (v.type) {
+    case Arg::I32: case Arg::I64: return static_cast<unsigned long long>(v.i);
+    case Arg::F64:                return static_cast<unsigned long long>(v.f);
+    default:                      return static_cast<unsigned long long>(v.u);
+  }
+}
+
+static double asDouble(const Value& v)
+{
+  switch (v.type) {
+    case Arg::I32: case Arg::I64: return static_cast<double>(v.i);
+    case Arg::F64:                return v.f;
+    default:                      return static_cast<double>(v.u);
+  }
+}
+// clang-format on
+
+template <typename... Args>
+static void append(std::string& out, const std::string& spec, Args... args)
+{
+  char buffer[512];
+  int  length = snprintf(buffer, sizeof(buffer), spec.c_str(), args...);
+  if (length < 0)
+    return;
+
+  if (static_cast<size_t>(length) < sizeof(buffer)) {
+    out.append(buffer, length);
+  }
+  else {
+    std::vector<char> extend(length + 1);
+    snprintf(extend.data(), extend.size(), spec.c_str(), args...);
+    out.append(extend.data(), length);
+  }
+}
+
+// reproduce printf output with the decoded arguments
+static std::string render(const std::string& fmt,
+                          const std::vector<Value>& values)
+{
+  std::string out;
+  size_t      arg = 0;
+  size_t      i = 0, n = fmt.size();
+
+  const auto nextInt = [&]() -> long long {
+    return (arg < values.size()) ? asSigned(values[arg++]) : 0;
+  };
+
+  while (i < n) {
+    if (fmt[i] != '%') {
+      out += fmt[i++];
+      continue;
+    }
+    if (i + 1 < n && fmt[i + 1] == '%') {
+      out += '%';
+      i += 2;
+      continue;
+    }
+
+    // %[flags][width][.precision][length]conversion
+    std::string spec = "%";
+    i++;
+    while (i < n && strchr("-+ #0", fmt[i]))
+      spec += fmt[i++];
+    if (i < n && fmt[i] == '*') {
+      spec += std::to_string(nextInt());
+      i++;
+    }
+    while (i < n && isdigit(static_cast<unsigned char>(fmt[i])))
+      spec += fmt[i++];
+    if (i < n && fmt[i] == '.') {
+      spec += fmt[i++];
+      if (i < n && fmt[i] == '*') {
+        spec += std::to_string(nextInt());
+        i++;
+      }
+      while (i < n && isdigit(static_cast<unsigned char>(fmt[i])))
+        spec += fmt[i++];
+    }
+    while (i < n && strchr("hlLqjzt", fmt[i]))
+      i++;
+    if (i >= n)
+      break;
+
+    char conversion = fmt[i++];
+    if (conversion == 'n')
+      continue;
+    if (arg >= values.size()) {
+      out += "(missing)";
+      continue;
+    }
+
+    const auto& value = values[arg++];
+    switch (conversion) {
+      case 'd':
+      case 'i':
+        append(out, spec + "lld", asSigned(value));
+        break;
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X':
+        append(out, spec + "ll" + conversion, asUnsigned(value));
+        break;
+      case 'c':
+        append(out, spec + "c", static_cast<int>(asSigned(value)));
+        break;
+      case 'e':
+      case 'E':
+      case 'f':
+      case 'F':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
+        append(out, spec + conversion, asDouble(value));
+        break;
+      case 'p':
+        append(out, spec + "p", reinterpret_cast<void*>(asUnsigned(value)));
+        break;
+      case 's':
+        if (value.type == Arg::STR)
+          append(out, spec + "s", value.str.c_str());
+        else if (value.type == Arg::F64)
+          append(out, "%g", value.f);
+        else
+          append(out, "%lld", asSigned(value));
+        break;
+      default:
+        out += spec + conversion;
+        break;
+    }
+  }
+  return out;
+}
+
+static bool decode(const char* path, bool header_date)
+{
+  FILE* file = fopen(path, "rb");
+  if (file == nullptr) {
+    fprintf(stderr, "log_decoder : cannot open %s\n", path);
+    return false;
+  }
+
+  std::vector<char> data;
+  char              chunk[65536];
+  size_t            read_size;
+  while ((read_size = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    data.insert(data.end(), chunk, chunk + read_size);
+  fclose(file);
+
+  std::unordered_map<uint32_t, Format> formats;
+
+  size_t     pos = 0;
+  const auto readable = [&](size_t length) {
+    return pos + length <= data.size();
+  };
+  const auto read = [&](void* dst, size_t length) {
+    memcpy(dst, data.data() + pos, length);
+    pos += length;
+  };
+
+  while (readable(1)) {
+    uint8_t kind;
+    read(&kind, 1);
+
+    if (kind == static_cast<uint8_t>(Kind::FILE_HEADER)) {
+      if (!readable(7) || memcmp(data.data() + pos, rs::binlog::MAGIC, 7)) {
+        fprintf(stderr, "log_decoder : %s : invalid header\n", path);
+        return false;
+      }
+      pos += 7;
+    }
+    else if (kind == static_cast<uint8_t>(Kind::FORMAT)) {
+      uint32_t id;
+      uint8_t  level;
+      int32_t  line;
+      uint16_t fmt_len, file_len;
+      if (!readable(13))
+        break;
+      read(&id, 4);
+      read(&level, 1);
+      read(&line, 4);
+      read(&fmt_len, 2);
+      read(&file_len, 2);
+      if (!readable(fmt_len + file_len))
+        break;
+
+      Format& format = formats[id];
+      format.level   = level;
+      format.line    = line;
+      format.fmt.assign(data.data() + pos, fmt_len);
+      format.file.assign(data.data() + pos + fmt_len, file_len);
+      pos += fmt_len + file_len;
+    }
+    else if (kind == static_cast<uint8_t>(Kind::RECORD)) {
+      uint32_t id;
+      uint64_t time_ns;
+      uint16_t payload_len;
+      if (!readable(14))
+        break;
+      read(&id, 4);
+      read(&time_ns, 8);
+      read(&payload_len, 2);
+      if (!readable(payload_len))
+        break;
+
+      // arguments (untrusted input : every read is checked against the
+      // payload, a record with a corrupted argument is skipped)
+      std::vector<Value> values;
+      size_t             start   = pos;
+      size_t             end     = pos + payload_len;
+      bool               corrupt = false;
+      const auto         take    = [&](void* dst, size_t length) {
+        if (pos + length > end) {
+          corrupt = true;
+          return false;
+        }
+        read(dst, length);
+        return true;
+      };
+
+      while (pos < end && corrupt == false) {
+        Value value;
+        value.type = static_cast<Arg>(data[pos++]);
+        switch (value.type) {
+          case Arg::I32: {
+            int32_t v;
+            if (take(&v, 4))
+              value.i = v;
+          } break;
+          case Arg::I64:
+            take(&value.i, 8);
+            break;
+          case Arg::U32: {
+            uint32_t v;
+            if (take(&v, 4))
+              value.u = v;
+          } break;
+          case Arg::U64:
+          case Arg::PTR:
+            take(&value.u, 8);
+            break;
+          case Arg::F64:
+            take(&value.f, 8);
+            break;
+          case Arg::STR: {
+            uint16_t length;
+            if (take(&length, 2) && pos + length <= end) {
+              value.str.assign(data.data() + pos, length);
+              pos += length;
+            }
+            else {
+              corrupt = true;
+            }
+          } break;
+          default:
+            corrupt = true;
+            break;
+        }
+        if (corrupt == false)
+          values.push_back(std::move(value));
+      }
+      pos = end;
+
+      if (corrupt) {
+        fprintf(stderr, "log_decoder : %s : corrupted arguments at %zu\n",
+                path, start);
+        continue;
+      }
+
+      auto it = formats.find(id);
+      if (it == formats.end()) {
+        fprintf(stderr, "log_decoder : %s : unknown format id %u\n", path, id);
+        continue;
+      }
+      const Format& format = it->second;
+
+      // [time] [LEVEL] msg  ... (file: line)
+      time_t    sec = static_cast<time_t>(time_ns / 1000000000);
+      int       ms  = static_cast<int>(time_ns / 1000000 % 1000);
+      struct tm tm;
+#ifdef _WIN32
+      localtime_s(&tm, &sec);
+#else
+      localtime_r(&sec, &tm);
+#endif
+      char timestamp[24];
+      if (header_date)
+        snprintf(timestamp, sizeof(timestamp),
+                 "%04d-%02d-%02d %02d:%02d:%02d.%03d", tm.tm_year + 1900,
+                 tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec,
+                 ms);
+      else
+        snprintf(timestamp, sizeof(timestamp), "%02d:%02d:%02d.%03d",
+                 tm.tm_hour, tm.tm_min, tm.tm_sec, ms);
+
+      printf("[%s] %-7s %s   ... (%s: %d)\n", timestamp, keyword(format.level),
+             render(format.fmt, values).c_str(), format.file.c_str(),
+             format.line);
+    }
+    else {
+      fprintf(stderr, "log_decoder : %s : corrupted record at %zu\n", path,
+              pos - 1);
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  bool header_date = false;
+  int  files       = 0;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-d") == 0) {
+      header_date = true;
+      continue;
+    }
+    if (decode(argv[i], header_date) == false)
+      return 1;
+    files++;
+  }
+
+  if (files == 0) {
+    printf("usage : %s [-d] <file.bin> ...\n", argv[0]);
+    printf("  -d : print date in the header\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,483 @@
+#ifdef _WIN32
+  #include <Windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "rowen/core.hpp"
+
+using rs::LogIndex;
+
+// read-only mapping of a whole file
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path)
+  {
+#ifdef _WIN32
+    file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ |
+                        FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE)
+      return;
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file_, &size) == FALSE || size.QuadPart == 0)
+      return;
+    mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_ == nullptr)
+      return;
+    data_ = static_cast<const char*>(
+        MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (data_)
+      size_ = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      return;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ,
+                        MAP_SHARED, fd, 0);
+      if (data != MAP_FAILED) {
+        data_ = static_cast<const char*>(data);
+        size_ = static_cast<size_t>(st.st_size);
+      }
+    }
+    ::close(fd);
+#endif
+  }
+
+  ~MappedFile()
+  {
+#ifdef _WIN32
+    if (data_)
+      UnmapViewOfFile(data_);
+    if (mapping_)
+      CloseHandle(mapping_);
+    if (file_ != INVALID_HANDLE_VALUE)
+      CloseHandle(file_);
+#else
+    if (data_)
+      munmap(const_cast<char*>(data_), size_);
+#endif
+  }
+
+  MappedFile(const MappedFile&)            = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const char* data() const { return data_; }
+  size_t      size() const { return size_; }
+
+  // sequential access : pages behind the reader are not kept
+  void advise(size_t offset, size_t length) const
+  {
+#ifndef _WIN32
+    size_t page  = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t begin = offset / page * page;
+    auto   start = const_cast<char*>(data_) + begin;
+
+    // (advice values are not flags : one call each)
+    madvise(start, offset + length - begin, MADV_SEQUENTIAL);
+    madvise(start, offset + length - begin, MADV_WILLNEED);
+#else
+    (void)offset;
+    (void)length;
+#endif
+  }
+
+ private:
+#ifdef _WIN32
+  HANDLE file_    = INVALID_HANDLE_VALUE;
+  HANDLE mapping_ = nullptr;
+#endif
+  const char* data_ = nullptr;
+  size_t      size_ = 0;
+};
+
+struct Query {
+  int64_t  from   = INT64_MIN;  // LogIndex::timeKey
+  int64_t  to     = INT64_MAX;
+  uint32_t levels = ~0u;  // 1 << Logger::Level
+
+  // "HH:MM[:SS]" : time of the day of each file
+  bool    time_only = false;
+  int64_t from_time = 0;
+  int64_t to_time   = 0;
+
+  bool verbose = false;
+};
+
+struct Stats {
+  uint64_t blocks  = 0;  // index blocks read
+  uint64_t skipped = 0;  // index blocks skipped
+  uint64_t bytes   = 0;  // bytes read
+  uint64_t lines   = 0;  // lines printed
+};
+
+static const int64_t DAY_MS = 86400000;
+
+// "YYYY-MM-DD HH:MM[:SS[.mmm]]" or "HH:MM[:SS[.mmm]]"
+static bool parseTime(const char* text, int64_t& key, bool& time_only)
+{
+  int  year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+  int  millisecond = 0;
+  bool date        = strlen(text) > 10 && text[4] == '-';
+  if (date) {
+    if (sscanf(text, "%d-%d-%d %d:%d:%d.%d", &year, &month, &day, &hour,
+               &minute, &second, &millisecond) < 5)
+      return false;
+    key = LogIndex::timeKey(year, month, day, hour, minute, second, millisecond);
+  }
+  else {
+    if (sscanf(text, "%d:%d:%d.%d", &hour, &minute, &second, &millisecond) < 2)
+      return false;
+    key = LogIndex::timeKey(1970, 1, 1, hour, minute, second, millisecond);
+  }
+  time_only = (date == false);
+  return true;
+}
+
+static int parseLevel(const char* text, size_t length)
+{
+  static const char* names[] = { "OFF",  "FATAL", "ERROR", "WARN",
+                                 "INFO", "DEBUG", "TRACE" };
+  for (int i = 1; i < 7; ++i) {
+    size_t name = strlen(names[i]);
+    if (length < name)
+      continue;
+    bool match = true;
+    for (size_t j = 0; j < name && match; ++j)
+      match = ((text[j] & ~0x20) == names[i][j]);
+    if (match)
+      return i;
+  }
+  return -1;
+}
+
+static bool digits(const char* text, int count, int& value)
+{
+  value = 0;
+  for (int i = 0; i < count; ++i) {
+    if (text[i] < '0' || text[i] > '9')
+      return false;
+    value = value * 10 + (text[i] - '0');
+  }
+  return true;
+}
+
+// "YYYY-MM-DD?HH:MM:SS.mmm" (23 characters)
+static bool parseDateTime(const char* text, const char* end, int64_t& key)
+{
+  int year, month, day, hour, minute, second, millisecond;
+  if (end - text < 23 || digits(text, 4, year) == false ||
+      digits(text + 5, 2, month) == false || digits(text + 8, 2, day) == false)
+    return false;
+  if (digits(text + 11, 2, hour) == false ||
+      digits(text + 14, 2, minute) == false ||
+      digits(text + 17, 2, second) == false ||
+      digits(text + 20, 3, millisecond) == false)
+    return false;
+  key = LogIndex::timeKey(year, month, day, hour, minute, second, millisecond);
+  return true;
+}
+
+// time & level of a record line (false : continuation or unknown line)
+//   [HH:MM:SS.mmm] [LEVEL] ...             (text, `date` : day of the file)
+//   [YYYY-MM-DD HH:MM:SS.mmm] [LEVEL] ...  (text with header date)
+//   {"time":"YYYY-MM-DDTHH:MM:SS.mmm","level":"info" ...  (JSON)
+//   time=YYYY-MM-DDTHH:MM:SS.mmm level=info ...           (logfmt)
+static bool parseLine(const char* line, const char* end, int64_t date,
+                      int64_t& key, int& level)
+{
+  const char* tag = nullptr;
+  if (end - line > 9 && memcmp(line, "{\"time\":\"", 9) == 0) {
+    if (parseDateTime(line + 9, end, key) == false)
+      return false;
+    tag = line + 9 + 23;
+    if (end - tag < 11 || memcmp(tag, "\",\"level\":\"", 11) != 0)
+      return false;
+    tag += 11;
+  }
+  else if (end - line > 5 && memcmp(line, "time=", 5) == 0) {
+    if (parseDateTime(line + 5, end, key) == false)
+      return false;
+    tag = line + 5 + 23;
+    if (end - tag < 7 || memcmp(tag, " level=", 7) != 0)
+      return false;
+    tag += 7;
+  }
+  else if (end - line > 15 && line[0] == '[') {
+    int hour, minute, second, millisecond;
+    if (line[5] == '-') {
+      if (parseDateTime(line + 1, end, key) == false)
+        return false;
+      tag = line + 1 + 23;
+    }
+    else {
+      if (digits(line + 1, 2, hour) == false ||
+          digits(line + 4, 2, minute) == false ||
+          digits(line + 7, 2, second) == false ||
+          digits(line + 10, 3, millisecond) == false)
+        return false;
+      key = date + ((hour * 60 + minute) * 60 + second) * 1000 + millisecond;
+      tag = line + 13;
+    }
+    if (end - tag < 3 || memcmp(tag, "] [", 3) != 0)
+      return false;
+    tag += 3;
+  }
+  else {
+    return false;
+  }
+
+  level = parseLevel(tag, end - tag);
+  return level > 0;
+}
+
+// print the records of the range matching the query
+static void scan(const MappedFile& file, size_t begin, size_t end,
+                 int64_t date, const Query& query, Stats& stats)
+{
+  file.advise(begin, end - begin);
+  stats.bytes += end - begin;
+
+  const char* data  = file.data();
+  const char* first = nullptr;  // first line of the pending output
+  bool        keep  = false;    // decision of the current record
+  size_t      pos   = begin;
+  while (pos < end) {
+    const char* line = data + pos;
+    auto next = static_cast<const char*>(memchr(line, '\n', end - pos));
+    const char* line_end = next ? next + 1 : data + end;
+
+    int64_t key;
+    int     level;
+    if (parseLine(line, line_end, date, key, level))
+      keep = (query.levels & (1u << level)) && key >= query.from &&
+             key <= query.to;
+
+    if (keep) {
+      if (first == nullptr)
+        first = line;
+      stats.lines++;
+    }
+    else if (first) {
+      fwrite(first, 1, line - first, stdout);
+      first = nullptr;
+    }
+    pos = line_end - data;
+  }
+  if (first)
+    fwrite(first, 1, data + end - first, stdout);
+}
+
+static bool queryFile(const std::string& path, Query query, Stats& stats)
+{
+  MappedFile log(path);
+  if (log.data() == nullptr) {
+    fprintf(stderr, "log_query : cannot read %s\n", path.c_str());
+    return false;
+  }
+
+  MappedFile              index(path + ".idx");
+  const LogIndex::Header* header = nullptr;
+  const LogIndex::Block*  blocks = nullptr;
+  size_t                  count  = 0;
+  if (index.size() >= sizeof(LogIndex::Header)) {
+    header = reinterpret_cast<const LogIndex::Header*>(index.data());
+    if (header->magic == LogIndex::MAGIC &&
+        header->version == LogIndex::VERSION) {
+      blocks = reinterpret_cast<const LogIndex::Block*>(header + 1);
+      count  = (index.size() - sizeof(LogIndex::Header)) /
+              sizeof(LogIndex::Block);
+    }
+  }
+  if (count == 0 && query.verbose)
+    fprintf(stderr, "log_query : %s is not indexed (full scan)\n",
+            path.c_str());
+
+  // day of the file (time of text headers) : YYYY_MM_DD-HH-NN.txt
+  int64_t date  = 0;
+  auto    slash = path.find_last_of("/\\");
+  auto    name  = path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+  int     year, month, day;
+  if (sscanf(name, "%4d_%2d_%2d-", &year, &month, &day) == 3)
+    date = LogIndex::timeKey(year, month, day, 0, 0, 0, 0);
+  else if (count > 0)
+    date = blocks[0].first_ms - (blocks[0].first_ms % DAY_MS + DAY_MS) % DAY_MS;
+
+  if (query.time_only) {
+    query.from = date + query.from_time;
+    query.to   = date + query.to_time;
+  }
+
+  // first block which may hold the range (blocks are in time order, a few
+  // records of asynchronous writers may be late : the previous block is
+  // checked too)
+  size_t low = 0, high = count;
+  while (low < high) {
+    size_t middle = (low + high) / 2;
+    if (blocks[middle].last_ms < query.from)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  if (low > 0)
+    low--;
+
+  // data before the index (index enabled later)
+  size_t cursor = count > 0 ? blocks[0].offset : log.size();
+  if (cursor > 0)
+    scan(log, 0, std::min(cursor, log.size()), date, query, stats);
+  if (low > 0)
+    cursor = blocks[low].offset;
+
+  for (size_t i = low; i < count; ++i) {
+    const auto& block = blocks[i];
+    if (block.offset + block.length > log.size())
+      break;  // (file truncated)
+    if (block.first_ms > query.to)
+      break;
+
+    // data not indexed (index restarted)
+    if (block.offset > cursor)
+      scan(log, cursor, block.offset, date, query, stats);
+    cursor = block.offset + block.length;
+
+    if ((block.levels & query.levels) == 0 || block.last_ms < query.from) {
+      stats.skipped++;
+      continue;
+    }
+    stats.blocks++;
+
+    // whole block matches : no line parsing
+    bool inside = block.first_ms >= query.from && block.last_ms <= query.to &&
+                  (block.levels & ~query.levels) == 0;
+    if (inside) {
+      log.advise(block.offset, block.length);
+      fwrite(log.data() + block.offset, 1, block.length, stdout);
+      stats.bytes += block.length;
+      stats.lines += block.count;
+    }
+    else {
+      scan(log, block.offset, cursor, date, query, stats);
+    }
+  }
+
+  // data after the last index block (not flushed yet)
+  if (count > 0 && blocks[count - 1].offset + blocks[count - 1].length <
+                       log.size()) {
+    cursor = blocks[count - 1].offset + blocks[count - 1].length;
+    scan(log, cursor, log.size(), date, query, stats);
+  }
+  return true;
+}
+
+static void usage(const char* program)
+{
+  printf("usage : %s [-f time] [-t time] [-l level] [-v] <file.txt> ...\n",
+         program);
+  printf("  -f : from \"YYYY-MM-DD HH:MM[:SS[.mmm]]\" or \"HH:MM[:SS]\"\n");
+  printf("  -t : to (inclusive, same format)\n");
+  printf("  -l : records of the level and higher (fatal ~ trace)\n");
+  printf("  -v : print the read statistics to stderr\n");
+  printf("  (files are indexed with Logger::setFileIndex)\n");
+}
+
+int main(int argc, char** argv)
+{
+  Query query;
+  int   files     = 0;
+  bool  from_time = false;
+  bool  to_time   = false;
+
+  for (int i = 1; i < argc; ++i) {
+    if ((strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "-t") == 0) &&
+        i + 1 < argc) {
+      bool    from = (argv[i][1] == 'f');
+      int64_t key;
+      bool    time_only;
+      if (parseTime(argv[++i], key, time_only) == false) {
+        fprintf(stderr, "log_query : invalid time %s\n", argv[i]);
+        return 1;
+      }
+      if (from) {
+        query.from = query.from_time = key;
+        from_time  = time_only;
+      }
+      else {
+        query.to = query.to_time = key;
+        to_time  = time_only;
+      }
+      continue;
+    }
+    if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+      int level = parseLevel(argv[i + 1], strlen(argv[i + 1]));
+      if (level < 0) {
+        fprintf(stderr, "log_query : invalid level %s\n", argv[i + 1]);
+        return 1;
+      }
+      query.levels = 0;
+      for (int l = 1; l <= level; ++l)
+        query.levels |= 1u << l;
+      i++;
+      continue;
+    }
+    if (strcmp(argv[i], "-v") == 0) {
+      query.verbose = true;
+      continue;
+    }
+    if (argv[i][0] == '-') {
+      usage(argv[0]);
+      return 1;
+    }
+    files++;
+  }
+
+  if (files == 0) {
+    usage(argv[0]);
+    return 1;
+  }
+  if (from_time != to_time && query.from != INT64_MIN &&
+      query.to != INT64_MAX) {
+    fprintf(stderr, "log_query : -f and -t must use the same format\n");
+    return 1;
+  }
+
+  // time of the day : an open end covers the whole day
+  query.time_only = from_time || to_time;
+  if (query.time_only) {
+    if (from_time == false)
+      query.from_time = 0;
+    if (to_time == false)
+      query.to_time = DAY_MS - 1;
+  }
+
+  Stats stats;
+  bool  success = true;
+  for (int i = 1; i < argc; ++i) {
+    if (argv[i][0] == '-') {
+      if (argv[i][1] != 'v')
+        i++;
+      continue;
+    }
+    success = queryFile(argv[i], query, stats) && success;
+  }
+  fflush(stdout);
+
+  if (query.verbose)
+    fprintf(stderr,
+            "log_query : %llu blocks read, %llu skipped, %llu bytes, %llu "
+            "lines\n",
+            static_cast<unsigned long long>(stats.blocks),
+            static_cast<unsigned long long>(stats.skipped),
+            static_cast<unsigned long long>(stats.bytes),
+            static_cast<unsigned long long>(stats.lines));
+  return success ? 0 : 1;
+}